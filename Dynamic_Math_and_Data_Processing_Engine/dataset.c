@@ -0,0 +1,132 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dataset.h"
+#include "typed.h"
+
+#define DATASET_MIN_CAPACITY 16
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+static int resize(Dataset *ds, int capacity) {
+    if (capacity == 0) {
+        free(ds->raw);
+        ds->raw = NULL;
+        ds->capacity = 0;
+        return 0;
+    }
+    void *tmp = realloc(ds->raw, (size_t)capacity * valueSize(ds->type));
+    if (!tmp)
+        return -1;
+    ds->raw = tmp;
+    ds->capacity = capacity;
+    return 0;
+}
+
+static void resetStats(Dataset *ds) {
+    memset(&ds->stats, 0, sizeof(ds->stats));
+    ds->stats.sumsKnown    = 1;
+    ds->stats.extremaKnown = 1;
+}
+
+static void dropIndex(Dataset *ds) {
+    free(ds->index);
+    ds->index = NULL;
+}
+
+/* Capacity for `needed` values: the current one doubled until it fits */
+static int grownCapacity(int current, int needed) {
+    long long cap = (current < DATASET_MIN_CAPACITY) ? DATASET_MIN_CAPACITY : current;
+    while (cap < needed)
+        cap *= 2;
+    return (cap > INT_MAX) ? INT_MAX : (int)cap;
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+void datasetInit(Dataset *ds) {
+    ds->raw = NULL;
+    ds->type = TYPE_I32;
+    ds->size = 0;
+    ds->capacity = 0;
+    ds->order = ORDER_ASCENDING | ORDER_DESCENDING;  /* trivially, while empty */
+    ds->index = NULL;
+    resetStats(ds);
+}
+
+void datasetFree(Dataset *ds) {
+    ValueType type = ds->type;
+    free(ds->raw);
+    free(ds->index);
+    datasetInit(ds);
+    ds->type = type;
+}
+
+void datasetSetType(Dataset *ds, ValueType type) {
+    datasetFree(ds);
+    ds->type = type;
+}
+
+void datasetClear(Dataset *ds) {
+    ds->size = 0;
+    ds->order = ORDER_ASCENDING | ORDER_DESCENDING;
+    dropIndex(ds);
+    resetStats(ds);
+}
+
+int datasetReserve(Dataset *ds, int capacity) {
+    if (capacity <= ds->capacity)
+        return 0;
+    return resize(ds, capacity);
+}
+
+int datasetShrinkToFit(Dataset *ds) {
+    if (ds->size == ds->capacity)
+        return 0;
+    return resize(ds, ds->size);
+}
+
+int datasetAppendValues(Dataset *ds, const void *values, int count) {
+    if (count <= 0)
+        return 0;
+    if (count > INT_MAX - ds->size)
+        return -1;
+    int needed = ds->size + count;
+    if (needed > ds->capacity && resize(ds, grownCapacity(ds->capacity, needed)) != 0)
+        return -1;
+    size_t width = valueSize(ds->type);
+    typedNoteAppend(ds, values, count);  /* order and running stats */
+    dropIndex(ds);
+    memcpy((char *)ds->raw + (size_t)ds->size * width, values, (size_t)count * width);
+    ds->size = needed;
+    return 0;
+}
+
+void datasetRemove(Dataset *ds, int index) {
+    typedNoteRemove(ds, index);
+    size_t width = valueSize(ds->type);
+    char *at = (char *)ds->raw + (size_t)index * width;
+    memmove(at, at + width, (size_t)(ds->size - index - 1) * width);
+    ds->size--;
+    dropIndex(ds);  /* positions after index moved; the order still holds */
+
+    /* Give memory back once three quarters are unused; halving (not
+       fitting exactly) leaves room so add/delete cycles don't thrash */
+    if (ds->capacity > DATASET_MIN_CAPACITY && ds->size <= ds->capacity / 4)
+        resize(ds, ds->capacity / 2);  /* on failure the larger block is kept */
+}
+
+void datasetReordered(Dataset *ds, unsigned order) {
+    ds->order = order;
+    dropIndex(ds);
+}
+
+void datasetRewritten(Dataset *ds, unsigned order) {
+    datasetReordered(ds, order);
+    ds->stats.sumsKnown    = 0;
+    ds->stats.extremaKnown = 0;
+}
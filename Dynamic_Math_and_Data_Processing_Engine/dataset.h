@@ -0,0 +1,100 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stdint.h>
+
+/*
+ * Dataset container
+ * -----------------
+ * Growable array of int32, int64, float or double values used by the engine:
+ *  - capacity grows geometrically (x2), so n appends cost O(n) copying
+ *    and O(log n) allocator calls
+ *  - reserve/shrink-to-fit give explicit control over the allocation
+ *  - functions that allocate return 0 on success and -1 on failure,
+ *    leaving the dataset unchanged
+ *  - the container tracks whether its values are currently in ascending
+ *    and/or descending order, so searches can use binary search
+ *  - a lookup index (built lazily by search.c) is dropped on any change
+ *  - running sums (count, sum, sum of squares, min/max) are updated on
+ *    every add, delete and load, so statistics don't rescan the data
+ *  - the int-only modules (intparse, intsort, reduce, search, pipeline,
+ *    stream) work on TYPE_I32 datasets through `data`; typed.c holds the
+ *    kernels for every type
+ */
+#define ORDER_ASCENDING  1u
+#define ORDER_DESCENDING 2u
+
+typedef struct ValueIndex ValueIndex;  /* search.c; a single malloc'd block */
+
+/* Exact integer sums; GCC and Clang provide it on every 64-bit target */
+__extension__ typedef __int128 WideInt;
+
+typedef union {
+    int     i32;
+    int64_t i64;
+    float   f32;
+    double  f64;
+} TypedValue;
+
+typedef enum {
+    TYPE_I32,
+    TYPE_I64,
+    TYPE_F32,
+    TYPE_F64
+} ValueType;
+
+/* Running aggregates over data[0..size), updated by every change (typed.c).
+   Squares are taken around a shift near the mean to keep them small. */
+typedef struct {
+    WideInt    isum;          /* integer types: exact */
+    double     fsum;          /* float and double */
+    double     shift;
+    double     shiftedSum;    /* sum of (x - shift) */
+    double     shiftedSq;     /* sum of (x - shift)^2 */
+    TypedValue min;
+    TypedValue max;
+    int        sumsKnown;     /* 0 after datasetRewritten or a delete that
+                                 cancelled most of shiftedSq, until recomputed */
+    int        extremaKnown;  /* 0 once the min or max is deleted, likewise */
+} RunningStats;
+
+typedef struct {
+    union {                /* the member matching type */
+        int     *data;     /* TYPE_I32 */
+        int64_t *i64;
+        float   *f32;
+        double  *f64;
+        void    *raw;
+    };
+    ValueType   type;
+    int         size;      /* values in use */
+    int         capacity;  /* values allocated */
+    unsigned    order;     /* ORDER_* bits that hold for data[0..size) */
+    ValueIndex *index;     /* NULL until a search builds it */
+    RunningStats stats;
+} Dataset;
+
+void datasetInit(Dataset *ds);  /* an empty TYPE_I32 dataset */
+void datasetFree(Dataset *ds);  /* keeps the type */
+/* Empty ds and switch it to type */
+void datasetSetType(Dataset *ds, ValueType type);
+void datasetClear(Dataset *ds);  /* size 0, keeps the allocation */
+
+/* Make room for at least `capacity` values */
+int  datasetReserve(Dataset *ds, int capacity);
+/* Release unused capacity (frees everything when empty) */
+int  datasetShrinkToFit(Dataset *ds);
+
+/* Append count values of ds->type in one copy, growing at most once */
+int  datasetAppendValues(Dataset *ds, const void *values, int count);
+/* Remove the value at index (must be valid), keeping the order of the rest */
+void datasetRemove(Dataset *ds, int index);
+
+/* Call after permuting data[] in place: drops the index and records the
+   order the values are now known to be in (0 if unknown) */
+void datasetReordered(Dataset *ds, unsigned order);
+/* Same, after replacing the values themselves (e.g. writing data[] and
+   size directly): the running statistics are recomputed on next use */
+void datasetRewritten(Dataset *ds, unsigned order);
+
+#endif /* DATASET_H */
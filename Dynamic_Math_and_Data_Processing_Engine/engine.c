@@ -1,65 +1,55 @@
 #include <stdio.h>
+#include <math.h>
 #include <stdlib.h>
 #include "engine.h"
+#include "intparse.h"
+#include "intsort.h"
+#include "search.h"
+#include "typed.h"
+
+#define SEARCH_SHOW_MAX 20  /* indices printed by a single search */
 
 /* ============================
  *   Utility Functions
  * ============================ */
 
-void printDataset(int *data, int size) {
-    if (size == 0) {
+void printDataset(const Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty.\n");
         return;
     }
-    printf("Dataset: ");
-    for (int i = 0; i < size; i++)
-        printf("%d ", data[i]);
+    printf("Dataset (%s): ", valueTypeName(ds->type));
+    typedWrite(stdout, ds, " ");
     printf("\n");
 }
 
-/* Dynamically add a value to the dataset */
-void addValue(int **data, int *size, int value) {
-    int *tmp = realloc(*data, (*size + 1) * sizeof(int));
-    if (!tmp) {
+/* Add a value (of the dataset's type; amortized O(1): capacity grows geometrically) */
+void addValue(Dataset *ds, const TypedValue *value) {
+    if (datasetAppendValues(ds, value, 1) != 0)
         printf("Memory allocation failed. Value not added.\n");
-        return;
+}
+
+/* Read one value of the given type from stdin; returns 0, or -1 if the
+   token is not a valid value (the reason is printed) */
+static int readValue(ValueType type, TypedValue *value) {
+    char tok[64];
+    const char *reason;
+    if (scanf("%63s", tok) != 1)
+        return -1;
+    if (typedParse(type, tok, value, &reason) != 0) {
+        printf("'%s' %s.\n", tok, reason);
+        return -1;
     }
-    *data = tmp;
-    (*data)[*size] = value;
-    (*size)++;
+    return 0;
 }
 
-/* Delete a value by index and shrink the dataset */
-void deleteValue(int **data, int *size, int index) {
-    if (*size == 0 || index < 0 || index >= *size) {
+/* Delete a value by index; the allocation shrinks once it is mostly unused */
+void deleteValue(Dataset *ds, int index) {
+    if (ds->size == 0 || index < 0 || index >= ds->size) {
         printf("Invalid index. Cannot delete.\n");
         return;
     }
-
-    /* Shift elements left from index */
-    for (int i = index; i < *size - 1; i++)
-        (*data)[i] = (*data)[i + 1];
-
-    int newSize = *size - 1;
-    int *tmp = NULL;
-
-    if (newSize > 0) {
-        tmp = realloc(*data, newSize * sizeof(int));
-        if (!tmp) {
-            /* Realloc failed, but original pointer is still valid;
-               we just keep the old allocation size (logical size is reduced). */
-            printf("Memory reallocation error. Logical size updated, physical size unchanged.\n");
-            *size = newSize;
-            return;
-        }
-        *data = tmp;
-        *size = newSize;
-    } else {
-        /* New size = 0 -> free and reset */
-        free(*data);
-        *data = NULL;
-        *size = 0;
-    }
+    datasetRemove(ds, index);
     printf("Value at index %d deleted successfully.\n", index);
 }
 
@@ -67,39 +57,42 @@ void deleteValue(int **data, int *size, int index) {
  *   File Handling
  * ============================ */
 
-/* Load integers from a file into the dataset */
-void loadDataFromFile(const char *filename, int **data, int *size) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
+/* Load values of the dataset's type from a file (int32 files are mapped
+   and parsed in parallel) */
+void loadDataFromFile(const char *filename, Dataset *ds) {
+    /* Parse into a fresh dataset so a failed load leaves the old one intact */
+    Dataset loaded;
+    long long skipped;
+    datasetInit(&loaded);
+    datasetSetType(&loaded, ds->type);
+    int rc = typedLoadFile(filename, &loaded, &skipped);
+    if (rc == INTPARSE_NO_FILE) {
         printf("File '%s' not found. No data loaded.\n", filename);
         return;
     }
-
-    /* Clear any existing data */
-    free(*data);
-    *data = NULL;
-    *size = 0;
-
-    int val;
-    while (fscanf(fp, "%d", &val) == 1) {
-        addValue(data, size, val);
+    if (rc == INTPARSE_NO_MEMORY) {
+        datasetFree(&loaded);
+        printf("Memory allocation failed. No data loaded.\n");
+        return;
     }
 
-    fclose(fp);
-    printf("Data loaded from '%s'. (%d value(s))\n", filename, *size);
+    datasetFree(ds);
+    *ds = loaded;
+    printf("Data loaded from '%s'. (%d value(s)", filename, ds->size);
+    if (skipped > 0)
+        printf(", %lld malformed token(s) skipped", skipped);
+    printf(")\n");
 }
 
 /* Save current dataset to a file */
-void saveDataToFile(const char *filename, int *data, int size) {
+void saveDataToFile(const char *filename, const Dataset *ds) {
     FILE *fp = fopen(filename, "w");
     if (!fp) {
         printf("Could not open '%s' for writing.\n", filename);
         return;
     }
 
-    for (int i = 0; i < size; i++)
-        fprintf(fp, "%d\n", data[i]);
-
+    typedWrite(fp, ds, "\n");
     fclose(fp);
     printf("Results saved to '%s'.\n", filename);
 }
@@ -108,96 +101,111 @@ void saveDataToFile(const char *filename, int *data, int size) {
  *   Operations via Function Pointers
  * ============================ */
 
-void op_sum(int *data, int size) {
-    if (size == 0) {
+/* Sum, average, max, min and statistics read the running aggregates the
+   dataset keeps across adds, deletes and loads (typedStats), so they cost
+   O(1); a full pass (the SIMD kernel for int32) is only needed to find a
+   new min/max after one was deleted */
+
+void op_sum(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Cannot compute sum.\n");
         return;
     }
-    int sum = 0;
-    for (int i = 0; i < size; i++)
-        sum += data[i];
-    printf("Sum = %d\n", sum);
+    TypedStats s;
+    char text[TYPED_TEXT_MAX];
+    typedStats(ds, &s);
+    typedFormatSum(ds->type, &s, text, sizeof(text));
+    printf("Sum = %s\n", text);
 }
 
-void op_average(int *data, int size) {
-    if (size == 0) {
+void op_average(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Cannot compute average.\n");
         return;
     }
-    int sum = 0;
-    for (int i = 0; i < size; i++)
-        sum += data[i];
-    printf("Average = %.2f\n", (float)sum / size);
+    TypedStats s;
+    typedStats(ds, &s);
+    printf("Average = %.2f\n", s.mean);
 }
 
-void op_max(int *data, int size) {
-    if (size == 0) {
+void op_max(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Cannot find maximum.\n");
         return;
     }
-    int max = data[0];
-    for (int i = 1; i < size; i++)
-        if (data[i] > max)
-            max = data[i];
-    printf("Max = %d\n", max);
+    TypedStats s;
+    char text[TYPED_TEXT_MAX];
+    typedStats(ds, &s);
+    typedFormat(ds->type, &s.max, text, sizeof(text));
+    printf("Max = %s\n", text);
 }
 
-void op_min(int *data, int size) {
-    if (size == 0) {
+void op_min(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Cannot find minimum.\n");
         return;
     }
-    int min = data[0];
-    for (int i = 1; i < size; i++)
-        if (data[i] < min)
-            min = data[i];
-    printf("Min = %d\n", min);
+    TypedStats s;
+    char text[TYPED_TEXT_MAX];
+    typedStats(ds, &s);
+    typedFormat(ds->type, &s.min, text, sizeof(text));
+    printf("Min = %s\n", text);
+}
+
+void op_statistics(Dataset *ds) {
+    if (ds->size == 0) {
+        printf("Dataset is empty. Cannot compute statistics.\n");
+        return;
+    }
+    TypedStats s;
+    char text[TYPED_TEXT_MAX];
+    typedStats(ds, &s);
+    printf("Count    = %lld\n", s.count);
+    typedFormatSum(ds->type, &s, text, sizeof(text));
+    printf("Sum      = %s\n", text);
+    typedFormat(ds->type, &s.min, text, sizeof(text));
+    printf("Min      = %s\n", text);
+    typedFormat(ds->type, &s.max, text, sizeof(text));
+    printf("Max      = %s\n", text);
+    printf("Mean     = %.4f\n", s.mean);
+    printf("Variance = %.4f\n", s.variance);
+    printf("Std dev  = %.4f\n", sqrt(s.variance));
 }
 
-/* Bubble sort ascending */
-void op_sortAscending(int *data, int size) {
-    if (size == 0) {
+/* Radix sort ascending (int32: intsort.c, parallel for large datasets;
+   other types: the typed radix kernel) */
+void op_sortAscending(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Nothing to sort.\n");
         return;
     }
-    for (int i = 0; i < size - 1; i++)
-        for (int j = 0; j < size - i - 1; j++)
-            if (data[j] > data[j + 1]) {
-                int t = data[j];
-                data[j] = data[j + 1];
-                data[j + 1] = t;
-            }
+    typedSort(ds, SORT_ASCENDING);
     printf("Sorted ascending.\n");
-    printDataset(data, size);
+    printDataset(ds);
 }
 
-/* Bubble sort descending */
-void op_sortDescending(int *data, int size) {
-    if (size == 0) {
+/* Radix sort descending: same kernels with the key order reversed */
+void op_sortDescending(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Nothing to sort.\n");
         return;
     }
-    for (int i = 0; i < size - 1; i++)
-        for (int j = 0; j < size - i - 1; j++)
-            if (data[j] < data[j + 1]) {
-                int t = data[j];
-                data[j] = data[j + 1];
-                data[j + 1] = t;
-            }
+    typedSort(ds, SORT_DESCENDING);
     printf("Sorted descending.\n");
-    printDataset(data, size);
+    printDataset(ds);
 }
 
-/* Linear search for a value */
-void op_search(int *data, int size) {
-    if (size == 0) {
+/* Find every index holding a value: binary search while the dataset is
+   sorted, otherwise a hash index built on first use (search.c) */
+void op_search(Dataset *ds) {
+    if (ds->size == 0) {
         printf("Dataset is empty. Nothing to search.\n");
         return;
     }
 
-    int target;
+    TypedValue target;
     printf("Enter value to search: ");
-    if (scanf("%d", &target) != 1) {
+    if (readValue(ds->type, &target) != 0) {
         printf("Invalid input. Search aborted.\n");
         /* clear stdin */
         int ch;
@@ -205,14 +213,58 @@ void op_search(int *data, int size) {
         return;
     }
 
-    for (int i = 0; i < size; i++) {
-        if (data[i] == target) {
-            printf("Value %d found at index %d.\n", target, i);
-            return;
-        }
+    SearchMatch m;
+    if (searchFind(ds, &target, &m) != 0) {
+        printf("Memory allocation failed. Search aborted.\n");
+        return;
     }
+    int count = m.count;
 
-    printf("Value %d not found in dataset.\n", target);
+    char text[TYPED_TEXT_MAX];
+    typedFormat(ds->type, &target, text, sizeof(text));
+    if (count == 0) {
+        printf("Value %s not found in dataset.\n", text);
+        return;
+    }
+
+    printf("Value %s found %d time(s) at index", text, count);
+    for (int k = 0; k < count && k < SEARCH_SHOW_MAX; k++)
+        printf(" %d", searchMatchAt(&m, k));
+    if (count > SEARCH_SHOW_MAX)
+        printf(" ... (%d more)", count - SEARCH_SHOW_MAX);
+    printf(".\n");
+}
+
+/* Look up every value listed in a file; all matches go to search_results.txt */
+void op_searchBatch(Dataset *ds) {
+    if (ds->type != TYPE_I32) {
+        printf("Batch search supports int32 datasets only.\n");
+        return;
+    }
+    char queryFile[256];
+    printf("Enter query file name: ");
+    if (scanf("%255s", queryFile) != 1) {
+        printf("Invalid input. Search aborted.\n");
+        return;
+    }
+
+    FILE *out = fopen("search_results.txt", "w");
+    if (!out) {
+        printf("Could not open 'search_results.txt' for writing.\n");
+        return;
+    }
+    BatchStats stats;
+    int rc = searchBatch(ds, queryFile, out, &stats);
+    fclose(out);
+
+    if (rc == INTPARSE_NO_FILE) {
+        printf("File '%s' not found. No queries run.\n", queryFile);
+        return;
+    }
+    if (rc == INTPARSE_NO_MEMORY)
+        printf("Memory allocation failed. Search stopped early.\n");
+    printf("%d quer%s, %d found, %lld match(es). Results saved to 'search_results.txt'.\n",
+           stats.queries, (stats.queries == 1) ? "y" : "ies", stats.found, stats.matches);
 }
 
 /* ============================
@@ -220,10 +272,11 @@ void op_search(int *data, int size) {
  * ============================ */
 
 void menu(void) {
-    int *data = NULL;
-    int size  = 0;
+    Dataset ds;
     int choice, val;
 
+    datasetInit(&ds);
+
     /* Array of function pointers for operations */
     Operation operations[] = {
         op_sum,            /* 0 */
@@ -232,8 +285,11 @@ void menu(void) {
         op_min,            /* 3 */
         op_sortAscending,  /* 4 */
         op_sortDescending, /* 5 */
-        op_search          /* 6 */
+        op_search,         /* 6 */
+        op_statistics,     /* 7 */
+        op_searchBatch     /* 8 */
     };
+    const int opCount = (int)(sizeof(operations) / sizeof(operations[0]));
 
     while (1) {
         printf("\n===== Dynamic Math & Data Engine =====\n");
@@ -243,6 +299,7 @@ void menu(void) {
         printf("4. Load from file (input.txt)\n");
         printf("5. Save to file (output.txt)\n");
         printf("6. Select & run operation (via function pointer)\n");
+        printf("7. Change value type (current: %s)\n", valueTypeName(ds.type));
         printf("0. Exit\n");
         printf("Choose: ");
 
@@ -254,16 +311,18 @@ void menu(void) {
         }
 
         switch (choice) {
-        case 1:
+        case 1: {
+            TypedValue value;
             printf("Enter number: ");
-            if (scanf("%d", &val) != 1) {
+            if (readValue(ds.type, &value) != 0) {
                 printf("Invalid input. Value not added.\n");
                 int ch;
                 while ((ch = getchar()) != '\n' && ch != EOF) {}
                 break;
             }
-            addValue(&data, &size, val);
+            addValue(&ds, &value);
             break;
+        }
 
         case 2:
             printf("Enter index to delete: ");
@@ -273,19 +332,19 @@ void menu(void) {
                 while ((ch = getchar()) != '\n' && ch != EOF) {}
                 break;
             }
-            deleteValue(&data, &size, val);
+            deleteValue(&ds, val);
             break;
 
         case 3:
-            printDataset(data, size);
+            printDataset(&ds);
             break;
 
         case 4:
-            loadDataFromFile("input.txt", &data, &size);
+            loadDataFromFile("input.txt", &ds);
             break;
 
         case 5:
-            saveDataToFile("output.txt", data, size);
+            saveDataToFile("output.txt", &ds);
             break;
 
         case 6:
@@ -297,6 +356,8 @@ void menu(void) {
             printf("4: Sort Ascending\n");
             printf("5: Sort Descending\n");
             printf("6: Search Value\n");
+            printf("7: Statistics (count, mean, variance)\n");
+            printf("8: Batch Search (queries from a file)\n");
             printf("Select operation index: ");
 
             if (scanf("%d", &val) != 1) {
@@ -306,16 +367,33 @@ void menu(void) {
                 break;
             }
 
-            if (val < 0 || val > 6) {
+            if (val < 0 || val >= opCount) {
                 printf("Invalid operation index.\n");
             } else {
                 Operation op = operations[val];
-                op(data, size);
+                op(&ds);
             }
             break;
 
+        case 7: {
+            char name[16];
+            ValueType type;
+            printf("Enter type (int32, int64, float, double): ");
+            if (scanf("%15s", name) != 1 || valueTypeFromName(name, &type) != 0) {
+                printf("Unknown type. Type unchanged.\n");
+                int ch;
+                while ((ch = getchar()) != '\n' && ch != EOF) {}
+                break;
+            }
+            if (type != ds.type) {
+                datasetSetType(&ds, type);
+                printf("Dataset cleared; values are now %s.\n", valueTypeName(type));
+            }
+            break;
+        }
+
         case 0:
-            free(data);
+            datasetFree(&ds);
             printf("Exiting. All dynamically allocated memory freed.\n");
             return;
 
@@ -2,34 +2,39 @@
 #define ENGINE_H
 
 #include <stdio.h>
+#include "dataset.h"
+#include "typed.h"
 
 /*
  * Dynamic Math & Data Processing Engine
  * -------------------------------------
  * Uses function pointers to dynamically dispatch operations
- * on an integer dataset that is managed with dynamic memory.
+ * on a dataset of int32, int64, float or double values that is
+ * managed with dynamic memory.
  */
 
 /* Function pointer type for operations on the dataset */
-typedef void (*Operation)(int *data, int size);
+typedef void (*Operation)(Dataset *ds);
 
 /* File I/O */
-void loadDataFromFile(const char *filename, int **data, int *size);
-void saveDataToFile(const char *filename, int *data, int size);
+void loadDataFromFile(const char *filename, Dataset *ds);
+void saveDataToFile(const char *filename, const Dataset *ds);
 
 /* Dataset management helpers */
-void printDataset(int *data, int size);
-void addValue(int **data, int *size, int value);
-void deleteValue(int **data, int *size, int index);
+void printDataset(const Dataset *ds);
+void addValue(Dataset *ds, const TypedValue *value);  /* value of ds->type */
+void deleteValue(Dataset *ds, int index);
 
 /* Operations executed via function pointers */
-void op_sum(int *data, int size);
-void op_average(int *data, int size);
-void op_max(int *data, int size);
-void op_min(int *data, int size);
-void op_sortAscending(int *data, int size);
-void op_sortDescending(int *data, int size);
-void op_search(int *data, int size);
+void op_sum(Dataset *ds);
+void op_average(Dataset *ds);
+void op_max(Dataset *ds);
+void op_min(Dataset *ds);
+void op_sortAscending(Dataset *ds);
+void op_sortDescending(Dataset *ds);
+void op_search(Dataset *ds);
+void op_statistics(Dataset *ds);   /* count, sum, min, max, mean, variance */
+void op_searchBatch(Dataset *ds);  /* int32: queries from a file, all matches to a file */
 
 /* Main menu controller */
 void menu(void);
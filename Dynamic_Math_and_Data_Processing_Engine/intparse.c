@@ -0,0 +1,314 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "intparse.h"
+
+#define PARSE_MIN_CHUNK   (1 << 20)  /* don't split below 1 MiB per thread */
+#define PARSE_MAX_THREADS 64
+#define PARSE_TOKEN_SHOWN 24         /* characters of a bad token echoed back */
+
+typedef struct {
+    long long   line;
+    const char *reason;
+    char        token[PARSE_TOKEN_SHOWN + 4];
+} ParseError;
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    Dataset     values;
+    long long   lines;    /* newlines in this chunk */
+    long long   errors;
+    ParseError  shown[INTPARSE_MAX_ERRORS_SHOWN];
+    int         failed;   /* out of memory */
+} ParseChunk;
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+static int isSpace(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int isDigit(unsigned char c) {
+    return (unsigned)(c - '0') < 10;
+}
+
+static void recordError(ParseChunk *c, long long line, const char *tok, const char *end,
+                        const char *reason) {
+    if (c->errors < INTPARSE_MAX_ERRORS_SHOWN) {
+        ParseError *e = &c->shown[c->errors];
+        size_t n = (size_t)(end - tok);
+        e->line   = line;
+        e->reason = reason;
+        if (n > PARSE_TOKEN_SHOWN) {
+            memcpy(e->token, tok, PARSE_TOKEN_SHOWN);
+            strcpy(e->token + PARSE_TOKEN_SHOWN, "...");
+        } else {
+            memcpy(e->token, tok, n);
+            e->token[n] = '\0';
+        }
+    }
+    c->errors++;
+}
+
+/*
+ * Parse one chunk into its private dataset. The common path (blank,
+ * newline, digits) is a few compares per byte; digits accumulate in 64
+ * bits and the range is checked once per token.
+ */
+static void *parseChunk(void *arg) {
+    ParseChunk *c = arg;
+    const char *p = c->begin, *end = c->end;
+    long long line = 1;  /* chunk-relative */
+
+    /* A value takes at least two bytes ("7\n"); start from a typical
+       width and let the buffer double past that */
+    long long guess = (end - p) / 6 + 16;
+    if (datasetReserve(&c->values, guess < INT_MAX ? (int)guess : INT_MAX) != 0) {
+        c->failed = 1;
+        return NULL;
+    }
+    Dataset *out = &c->values;
+
+    while (p < end) {
+        unsigned char ch = (unsigned char)*p;
+        if (ch == '\n') {
+            line++;
+            p++;
+            continue;
+        }
+        if (isSpace(ch)) {
+            p++;
+            continue;
+        }
+
+        const char *tok = p;
+        int neg = (ch == '-');
+        if (ch == '-' || ch == '+')
+            p++;
+        const char *digits = p;
+        uint64_t v = 0;
+        while (p < end && isDigit((unsigned char)*p) && p - digits < 19) {
+            v = v * 10 + (uint64_t)(*p - '0');
+            p++;
+        }
+
+        if (p == digits || (p < end && !isSpace((unsigned char)*p)) ||
+            v > (neg ? (uint64_t)INT_MAX + 1 : (uint64_t)INT_MAX)) {
+            int allDigits = (p > digits);
+            while (p < end && !isSpace((unsigned char)*p)) {
+                allDigits &= isDigit((unsigned char)*p);
+                p++;
+            }
+            recordError(c, line, tok, p, allDigits ? "is out of range" : "is not an integer");
+            continue;
+        }
+
+        if (out->size == out->capacity &&
+            datasetReserve(out, out->capacity < INT_MAX / 2 ? out->capacity * 2 : INT_MAX) != 0) {
+            c->failed = 1;
+            return NULL;
+        }
+        out->data[out->size++] = (int)(neg ? -(int64_t)v : (int64_t)v);
+    }
+    c->lines = line - 1;
+    return NULL;
+}
+
+static int onlineCpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > PARSE_MAX_THREADS) n = PARSE_MAX_THREADS;
+    return (int)n;
+}
+
+/*
+ * Parse data[0..len) and append the values to ds. Skipped tokens are added
+ * to *errors and printed (numbered from lineBase) while *shown is under
+ * the limit. *lines receives the number of newlines consumed.
+ */
+static int parseBlock(const char *data, size_t len, int threads, Dataset *ds,
+                      long long lineBase, long long *errors, int *shown, long long *lines) {
+    *lines = 0;
+    if (ds->type != TYPE_I32)
+        return INTPARSE_BAD_TYPE;
+    if (threads <= 0)
+        threads = onlineCpus();
+    if ((size_t)threads > len / PARSE_MIN_CHUNK)
+        threads = (int)(len / PARSE_MIN_CHUNK);
+    if (threads < 1)
+        threads = 1;
+
+    ParseChunk chunks[PARSE_MAX_THREADS];
+    pthread_t  tids[PARSE_MAX_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+
+    /* Split on line boundaries: each chunk ends just after a newline */
+    const char *start = data, *limit = data + len;
+    for (int t = 0; t < threads; t++) {
+        const char *end = (t == threads - 1) ? limit : data + len / threads * (t + 1);
+        if (end < start) end = start;
+        if (end < limit) {
+            const char *nl = memchr(end, '\n', (size_t)(limit - end));
+            end = nl ? nl + 1 : limit;
+        }
+        chunks[t].begin = start;
+        chunks[t].end   = end;
+        datasetInit(&chunks[t].values);
+        start = end;
+    }
+
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, parseChunk, &chunks[t]) != 0)
+            break;
+        started = t;
+    }
+    parseChunk(&chunks[0]);
+    for (int t = 1; t <= started; t++)
+        pthread_join(tids[t], NULL);
+    for (int t = started + 1; t < threads; t++)
+        parseChunk(&chunks[t]);  /* thread creation failed: parse inline */
+
+    /* Reserve once, then append the chunks in file order */
+    long long total = 0;
+    int failed = 0;
+    for (int t = 0; t < threads; t++) {
+        total  += chunks[t].values.size;
+        failed |= chunks[t].failed;
+    }
+    if (!failed && (total > INT_MAX - ds->size || datasetReserve(ds, ds->size + (int)total) != 0))
+        failed = 1;
+
+    *lines = 0;
+    for (int t = 0; t < threads; t++) {
+        ParseChunk *c = &chunks[t];
+        if (!failed)
+            datasetAppendValues(ds, c->values.data, c->values.size);  /* fits: reserved above */
+        for (int e = 0; e < c->errors && e < INTPARSE_MAX_ERRORS_SHOWN; e++) {
+            if ((*shown)++ < INTPARSE_MAX_ERRORS_SHOWN)
+                printf("Line %lld: '%s' %s; skipped.\n",
+                       lineBase + *lines + c->shown[e].line, c->shown[e].token, c->shown[e].reason);
+        }
+        *errors += c->errors;
+        *lines  += c->lines;
+        datasetFree(&c->values);
+    }
+    return failed ? INTPARSE_NO_MEMORY : INTPARSE_OK;
+}
+
+static void reportHidden(long long errors, int shown) {
+    if (errors > shown)
+        printf("... %lld more malformed token(s) skipped.\n", errors - shown);
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+int parseIntegers(const char *data, size_t len, int threads, Dataset *ds, long long *errors) {
+    int shown = 0;
+    long long lines;
+    *errors = 0;
+    int rc = parseBlock(data, len, threads, ds, 0, errors, &shown, &lines);
+    reportHidden(*errors, shown);
+    return rc;
+}
+
+int parseIntegerFile(const char *filename, Dataset *ds, long long *errors) {
+    *errors = 0;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return INTPARSE_NO_FILE;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return INTPARSE_NO_FILE;
+    }
+
+    size_t len = (size_t)st.st_size;
+    if (len == 0) {
+        close(fd);
+        return INTPARSE_OK;
+    }
+    void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return INTPARSE_NO_FILE;
+    posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+
+    int rc = parseIntegers(map, len, 0, ds, errors);
+    munmap(map, len);
+    return rc;
+}
+
+int intReaderOpen(IntReader *r, const char *filename, size_t blockBytes) {
+    memset(r, 0, sizeof(*r));
+    r->fd = open(filename, O_RDONLY);
+    if (r->fd < 0)
+        return INTPARSE_NO_FILE;
+    r->size = (blockBytes < 4096) ? 4096 : blockBytes;
+    r->buf  = malloc(r->size);
+    if (!r->buf) {
+        close(r->fd);
+        return INTPARSE_NO_MEMORY;
+    }
+    posix_fadvise(r->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return INTPARSE_OK;
+}
+
+int intReaderNext(IntReader *r, Dataset *ds) {
+    if (ds->type != TYPE_I32)
+        return INTPARSE_BAD_TYPE;
+    datasetClear(ds);
+    while (ds->size == 0 && !(r->eof && r->have == 0)) {
+        while (!r->eof && r->have < r->size) {
+            ssize_t n = read(r->fd, r->buf + r->have, r->size - r->have);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                return INTPARSE_NO_FILE;
+            if (n == 0)
+                r->eof = 1;
+            r->have += (size_t)n;
+        }
+
+        /* Parse up to the last blank; a token cut by the block end waits
+           for the next read (unless it fills the whole block) */
+        size_t cut = r->have;
+        if (!r->eof) {
+            while (cut > 0 && !isSpace((unsigned char)r->buf[cut - 1]))
+                cut--;
+            if (cut == 0)
+                cut = r->have;
+        }
+        long long lines;
+        int rc = parseBlock(r->buf, cut, 0, ds, r->line, &r->errors, &r->shown, &lines);
+        if (rc != INTPARSE_OK)
+            return rc;
+        r->line += lines;
+        memmove(r->buf, r->buf + cut, r->have - cut);
+        r->have -= cut;
+    }
+    return INTPARSE_OK;
+}
+
+void intReaderClose(IntReader *r) {
+    reportHidden(r->errors, r->shown);
+    free(r->buf);
+    close(r->fd);
+    r->buf = NULL;
+    r->fd  = -1;
+}
@@ -0,0 +1,55 @@
+#ifndef INTPARSE_H
+#define INTPARSE_H
+
+#include <stddef.h>
+#include "dataset.h"
+
+/*
+ * Integer file parser
+ * -------------------
+ * Reads whitespace-separated integers (one per line in input.txt):
+ *  - the file is memory-mapped and parsed in place, without stdio
+ *  - large inputs are split on line boundaries into one chunk per core,
+ *    each parsed by its own thread into a private buffer
+ *  - chunks are appended in file order with one reservation
+ *  - malformed or out-of-range tokens are reported with their line
+ *    number and skipped
+ *  - IntReader parses a file one fixed-size block at a time instead, for
+ *    inputs too large to hold in memory
+ */
+#define INTPARSE_OK         0
+#define INTPARSE_NO_FILE   (-1)  /* could not open or map the file */
+#define INTPARSE_NO_MEMORY (-2)
+#define INTPARSE_BAD_TYPE  (-3)  /* ds is not an int32 dataset */
+
+#define INTPARSE_MAX_ERRORS_SHOWN 10
+
+/*
+ * Append the integers in data[0..len) to ds, which must be int32, using up
+ * to threads threads (0 = one per core). *errors receives the number of skipped tokens.
+ * On failure ds keeps its previous contents.
+ */
+int parseIntegers(const char *data, size_t len, int threads, Dataset *ds, long long *errors);
+
+/* Map filename and parseIntegers it */
+int parseIntegerFile(const char *filename, Dataset *ds, long long *errors);
+
+/* Block-at-a-time reader; memory is the block plus one block's values */
+typedef struct {
+    int       fd;
+    char     *buf;
+    size_t    size;    /* block bytes */
+    size_t    have;    /* bytes in buf, starting with a carried-over token */
+    long long line;    /* newlines consumed so far */
+    long long errors;  /* tokens skipped so far */
+    int       shown;
+    int       eof;
+} IntReader;
+
+int  intReaderOpen(IntReader *r, const char *filename, size_t blockBytes);
+/* Replace int32 ds's contents with the next block's values; size 0 at the end */
+int  intReaderNext(IntReader *r, Dataset *ds);
+/* Reports how many skipped tokens went unprinted */
+void intReaderClose(IntReader *r);
+
+#endif /* INTPARSE_H */
@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "intsort.h"
+
+#define SORT_SMALL        64         /* insertion sort below this many values */
+#define SORT_MIN_SHARE    (1 << 18)  /* values per thread before going parallel */
+#define SORT_MAX_THREADS  64
+#define RADIX_BITS        11
+#define RADIX_BUCKETS     (1 << RADIX_BITS)
+#define RADIX_PASSES      ((32 + RADIX_BITS - 1) / RADIX_BITS)
+
+/* Shared state of one sort; thread t owns slice t and counts[t] */
+typedef struct {
+    int               *src;
+    int               *dst;
+    int                size;
+    uint32_t           mask;      /* key = value ^ mask */
+    int                threads;
+    int               *result;    /* buffer holding the sorted values */
+    size_t             counts[SORT_MAX_THREADS][RADIX_BUCKETS];
+    pthread_barrier_t  barrier;
+    pthread_mutex_t    lock;      /* guards go */
+    pthread_cond_t     start;
+    int                go;        /* set once threads and the barrier are final */
+} RadixJob;
+
+typedef struct {
+    RadixJob *job;
+    int       index;
+} RadixWorker;
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+/* Ascending: flip the sign bit so negatives order first.
+   Descending: flip every other bit as well, reversing the order. */
+static uint32_t orderMask(SortOrder order) {
+    return (order == SORT_ASCENDING) ? 0x80000000U : 0x7FFFFFFFU;
+}
+
+static void insertionSort(int *data, int size, uint32_t mask) {
+    for (int i = 1; i < size; i++) {
+        int v = data[i];
+        uint32_t key = (uint32_t)v ^ mask;
+        int j = i - 1;
+        while (j >= 0 && ((uint32_t)data[j] ^ mask) > key) {
+            data[j + 1] = data[j];
+            j--;
+        }
+        data[j + 1] = v;
+    }
+}
+
+static void *radixWorker(void *arg) {
+    RadixWorker *w = arg;
+    RadixJob *job = w->job;
+
+    pthread_mutex_lock(&job->lock);
+    while (!job->go)
+        pthread_cond_wait(&job->start, &job->lock);
+    pthread_mutex_unlock(&job->lock);
+
+    int t = w->index, threads = job->threads;
+    int lo = (int)((long long)job->size * t / threads);
+    int hi = (int)((long long)job->size * (t + 1) / threads);
+    int *src = job->src, *dst = job->dst;
+    uint32_t mask = job->mask;
+    size_t *hist = job->counts[t];
+
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        int shift = pass * RADIX_BITS;
+        memset(hist, 0, RADIX_BUCKETS * sizeof(size_t));
+        for (int i = lo; i < hi; i++)
+            hist[(((uint32_t)src[i] ^ mask) >> shift) & (RADIX_BUCKETS - 1)]++;
+        pthread_barrier_wait(&job->barrier);
+
+        /* Where this slice's values of each digit go: after every smaller
+           digit, and after the same digit in earlier slices. Every thread
+           sees the same totals, so all agree on skipping a pass. */
+        size_t offset[RADIX_BUCKETS], base = 0;
+        int skip = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            size_t before = 0, total = 0;
+            for (int u = 0; u < threads; u++) {
+                if (u < t) before += job->counts[u][b];
+                total += job->counts[u][b];
+            }
+            if (total == (size_t)job->size)
+                skip = 1;
+            offset[b] = base + before;
+            base += total;
+        }
+
+        if (!skip) {
+            for (int i = lo; i < hi; i++) {
+                int v = src[i];
+                dst[offset[(((uint32_t)v ^ mask) >> shift) & (RADIX_BUCKETS - 1)]++] = v;
+            }
+            int *tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+        /* Also keeps counts[] intact until every thread has read it */
+        pthread_barrier_wait(&job->barrier);
+    }
+    if (t == 0)
+        job->result = src;
+    return NULL;
+}
+
+static int onlineCpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > SORT_MAX_THREADS) n = SORT_MAX_THREADS;
+    return (int)n;
+}
+
+static int compareAscending(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int compareDescending(const void *a, const void *b) {
+    return compareAscending(b, a);
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+void sortInts(int *data, int size, SortOrder order, int threads) {
+    uint32_t mask = orderMask(order);
+    if (size < SORT_SMALL) {
+        insertionSort(data, size, mask);
+        return;
+    }
+
+    RadixJob *job = malloc(sizeof(RadixJob));
+    int *buffer = malloc((size_t)size * sizeof(int));
+    if (!job || !buffer) {
+        /* No room for the scatter buffer: sort in place instead */
+        free(job);
+        free(buffer);
+        qsort(data, (size_t)size, sizeof(int),
+              (order == SORT_ASCENDING) ? compareAscending : compareDescending);
+        return;
+    }
+
+    if (threads <= 0)
+        threads = onlineCpus();
+    if (threads > size / SORT_MIN_SHARE)
+        threads = size / SORT_MIN_SHARE;
+    if (threads < 1)
+        threads = 1;
+
+    job->src  = data;
+    job->dst  = buffer;
+    job->size = size;
+    job->mask = mask;
+    job->go   = 0;
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->start, NULL);
+
+    /* Start the helpers first; the slices and the barrier are sized by
+       however many actually started (the caller is thread 0) */
+    RadixWorker workers[SORT_MAX_THREADS];
+    pthread_t tids[SORT_MAX_THREADS];
+    int started = 1;
+    for (int t = 1; t < threads; t++) {
+        workers[t].job   = job;
+        workers[t].index = t;
+        if (pthread_create(&tids[t], NULL, radixWorker, &workers[t]) != 0)
+            break;
+        started++;
+    }
+    job->threads = started;
+    pthread_barrier_init(&job->barrier, NULL, (unsigned)started);
+    pthread_mutex_lock(&job->lock);
+    job->go = 1;
+    pthread_cond_broadcast(&job->start);
+    pthread_mutex_unlock(&job->lock);
+
+    workers[0].job   = job;
+    workers[0].index = 0;
+    radixWorker(&workers[0]);
+    for (int t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+
+    /* An odd number of passes ran: the result is in the scratch buffer */
+    if (job->result != data)
+        memcpy(data, job->result, (size_t)size * sizeof(int));
+
+    pthread_barrier_destroy(&job->barrier);
+    pthread_cond_destroy(&job->start);
+    pthread_mutex_destroy(&job->lock);
+    free(buffer);
+    free(job);
+}
@@ -0,0 +1,26 @@
+#ifndef INTSORT_H
+#define INTSORT_H
+
+/*
+ * Integer sort engine
+ * -------------------
+ * LSD radix sort over 32-bit keys, 11 bits per pass (3 passes):
+ *  - each value is mapped to an unsigned key (sign bit flipped); for
+ *    descending order the remaining bits are flipped too, so both
+ *    orders run the same kernel
+ *  - a pass whose digit is the same for every value is skipped, so
+ *    narrow ranges (e.g. 0..2047) cost one pass
+ *  - large inputs are split across threads: each thread counts its
+ *    slice, the counts are combined into per-thread offsets, and each
+ *    thread scatters its own slice (stable, like the serial version)
+ *  - small arrays use insertion sort on the same keys
+ */
+typedef enum {
+    SORT_ASCENDING,
+    SORT_DESCENDING
+} SortOrder;
+
+/* Sort data[0..size) with up to threads threads (0 = one per core) */
+void sortInts(int *data, int size, SortOrder order, int threads);
+
+#endif /* INTSORT_H */
@@ -1,6 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "engine.h"
+#include "intparse.h"
+#include "pipeline.h"
+#include "stream.h"
 
-int main(void) {
-    menu();
+static void usage(const char *prog) {
+    printf("Usage: %s                       interactive menu\n", prog);
+    printf("       %s [-i FILE] -e SPEC ...  run pipeline specs on FILE (default input.txt)\n", prog);
+    printf("       %s [-i FILE] -f SCRIPT    run a pipeline script\n", prog);
+    printf("       %s [-i FILE] [-m MIB] -r  stream FILE through count/sum/min/max/mean\n", prog);
+    printf("       %s [-i FILE] [-m MIB] [-o OUT] -s asc|desc\n", prog);
+    printf("                                  external sort of FILE into OUT (default output.txt)\n");
+    printf("SPEC example: \"filter >= 10 | sort desc | take 5 | stats\"\n");
+}
+
+/* Load filename into ds quietly; returns 0 or -1 */
+static int loadInput(const char *filename, Dataset *ds) {
+    Dataset loaded;
+    long long skipped;
+    datasetInit(&loaded);
+    int rc = parseIntegerFile(filename, &loaded, &skipped);
+    if (rc != INTPARSE_OK) {
+        datasetFree(&loaded);
+        printf("%s '%s'. No data loaded.\n",
+               (rc == INTPARSE_NO_FILE) ? "Could not read" : "Out of memory loading", filename);
+        return -1;
+    }
+    datasetFree(ds);
+    *ds = loaded;
     return 0;
-}
\ No newline at end of file
+}
+
+/* -r and -s: the file is streamed within memoryBytes, never loaded */
+static int runStream(int opt, const char *arg, const char *input, const char *output,
+                     size_t memoryBytes) {
+    StreamStats stats;
+    int rc;
+    if (opt == 'r') {
+        Reduction r;
+        rc = streamReduce(input, memoryBytes, &r, &stats);
+        if (rc == STREAM_OK && r.count == 0)
+            printf("count=0\n");
+        else if (rc == STREAM_OK)
+            printf("count=%lld sum=%lld min=%d max=%d mean=%.4f variance=%.4f\n",
+                   r.count, r.sum, r.min, r.max, r.mean, r.variance);
+    } else {
+        int desc = (strcmp(arg, "desc") == 0);
+        if (!desc && strcmp(arg, "asc") != 0) {
+            printf("Sort order must be 'asc' or 'desc'.\n");
+            return -1;
+        }
+        rc = streamSort(input, output, desc ? SORT_DESCENDING : SORT_ASCENDING, memoryBytes, &stats);
+        if (rc == STREAM_OK)
+            printf("Sorted %lld value(s) into '%s' (%d run(s), %d merge pass(es)).\n",
+                   stats.values, output, stats.runs, stats.passes);
+    }
+
+    if (rc == STREAM_NO_FILE)
+        printf("Could not read '%s'.\n", input);
+    else if (rc == STREAM_NO_MEMORY)
+        printf("Memory allocation failed.\n");
+    else if (rc == STREAM_IO)
+        printf("Could not write '%s' or a temporary run file.\n", output);
+    return (rc == STREAM_OK) ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 1) {
+        menu();
+        return 0;
+    }
+
+    /* Options run in order: -i/-o/-m set up, -e/-f/-r/-s run with them */
+    Dataset ds;
+    const char *input = "input.txt", *output = "output.txt";
+    size_t memoryBytes = STREAM_DEFAULT_MEMORY;
+    int loaded = 0, ran = 0, failed = 0, opt;
+    datasetInit(&ds);
+
+    while (!failed && (opt = getopt(argc, argv, "i:e:f:m:o:rs:h")) != -1) {
+        if (opt == 'i') {
+            input  = optarg;
+            loaded = 0;
+            continue;
+        }
+        if (opt == 'o') {
+            output = optarg;
+            continue;
+        }
+        if (opt == 'm') {
+            char *end;
+            unsigned long mib = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || mib == 0 || mib > (SIZE_MAX >> 20)) {
+                printf("Memory budget must be a positive number of MiB.\n");
+                failed = 1;
+                break;
+            }
+            memoryBytes = (size_t)mib << 20;
+            continue;
+        }
+        if (opt == 'r' || opt == 's') {
+            failed = (runStream(opt, optarg, input, output, memoryBytes) != 0);
+            ran = 1;
+            continue;
+        }
+        if (opt != 'e' && opt != 'f') {
+            usage(argv[0]);
+            datasetFree(&ds);
+            return (opt == 'h') ? 0 : 1;
+        }
+        if (!loaded) {
+            if (loadInput(input, &ds) != 0) {
+                failed = 1;
+                break;
+            }
+            loaded = 1;
+        }
+        ran = 1;
+
+        if (opt == 'f') {
+            failed = (pipelineRunScript(optarg, &ds) != PIPELINE_OK);
+            continue;
+        }
+        Pipeline p;
+        PipelineResult r;
+        int rc = pipelineParse(optarg, &p);
+        if (rc == PIPELINE_OK)
+            rc = pipelineRun(&p, &ds, &r);
+        if (rc != PIPELINE_OK) {
+            printf("'%s': %s.\n", optarg, pipelineError(rc));
+            failed = 1;
+            continue;
+        }
+        pipelinePrintResult(&r);
+        pipelineResultFree(&r);
+    }
+
+    if (!failed && (!ran || optind < argc)) {
+        usage(argv[0]);
+        failed = 1;
+    }
+    datasetFree(&ds);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,519 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pipeline.h"
+#include "intparse.h"
+
+#define PIPELINE_CHUNK  4096  /* filtered values buffered per sink call */
+#define SCRIPT_LINE_MAX 1024
+
+/* The values a stage sees: the caller's dataset, or a private copy */
+typedef struct {
+    const int *data;
+    int        size;
+    int       *owned;     /* == data once the view has its own copy */
+    int        capacity;  /* values allocated in owned */
+    unsigned   order;     /* ORDER_* bits that hold for data[0..size) */
+} View;
+
+/* Filters, and a take after them, not yet applied to the view */
+typedef struct {
+    const Stage *filters[PIPELINE_MAX_STAGES];
+    int          filterCount;
+    int          limit;  /* -1: none */
+} Pending;
+
+/* Receives the surviving values in order, one run at a time */
+typedef int (*Sink)(void *ctx, const int *values, int count);
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+static int passes(const Pending *pd, int v) {
+    for (int k = 0; k < pd->filterCount; k++) {
+        int x = pd->filters[k]->operand;
+        int ok;
+        switch (pd->filters[k]->cmp) {
+        case CMP_LT: ok = v <  x; break;
+        case CMP_LE: ok = v <= x; break;
+        case CMP_GT: ok = v >  x; break;
+        case CMP_GE: ok = v >= x; break;
+        case CMP_EQ: ok = v == x; break;
+        default:     ok = v != x; break;
+        }
+        if (!ok)
+            return 0;
+    }
+    return 1;
+}
+
+/* Feed the view through the pending stages into sink. Unfiltered data is
+   handed over in place; filtered values go through a small stack buffer. */
+static int drain(const View *v, const Pending *pd, Sink sink, void *ctx) {
+    if (pd->filterCount == 0) {
+        int n = (pd->limit >= 0 && pd->limit < v->size) ? pd->limit : v->size;
+        return (n > 0) ? sink(ctx, v->data, n) : PIPELINE_OK;
+    }
+
+    int chunk[PIPELINE_CHUNK];
+    int n = 0;
+    int left = (pd->limit >= 0) ? pd->limit : INT_MAX;
+    for (int i = 0; i < v->size && left > 0; i++) {
+        if (!passes(pd, v->data[i]))
+            continue;
+        chunk[n++] = v->data[i];
+        left--;
+        if (n == PIPELINE_CHUNK) {
+            int rc = sink(ctx, chunk, n);
+            if (rc != PIPELINE_OK)
+                return rc;
+            n = 0;
+        }
+    }
+    return (n > 0) ? sink(ctx, chunk, n) : PIPELINE_OK;
+}
+
+typedef struct {
+    int *dst;
+    int  count;
+} CopyTarget;
+
+static int copySink(void *ctx, const int *values, int count) {
+    CopyTarget *t = ctx;
+    /* memmove: compacting an owned view in place can pass dst itself */
+    memmove(t->dst + t->count, values, (size_t)count * sizeof(int));
+    t->count += count;
+    return PIPELINE_OK;
+}
+
+/* Apply the pending stages, giving the view its own copy if it has none.
+   The filters write straight into the copy, so nothing is copied twice. */
+static int materialize(View *v, Pending *pd) {
+    int *dst = v->owned;
+    int capacity = v->capacity;
+    if (!dst) {
+        capacity = (pd->limit >= 0 && pd->limit < v->size) ? pd->limit : v->size;
+        if (capacity == 0)
+            capacity = 1;
+        dst = malloc((size_t)capacity * sizeof(int));
+        if (!dst)
+            return PIPELINE_NO_MEMORY;
+    }
+
+    CopyTarget t = { dst, 0 };
+    drain(v, pd, copySink, &t);
+    v->owned    = dst;
+    v->data     = dst;
+    v->size     = t.count;
+    v->capacity = capacity;
+    pd->filterCount = 0;
+    pd->limit       = -1;
+    return PIPELINE_OK;
+}
+
+static int countSink(void *ctx, const int *values, int count) {
+    (void)values;
+    *(long long *)ctx += count;
+    return PIPELINE_OK;
+}
+
+static int reduceSink(void *ctx, const int *values, int count) {
+    Reduction part;
+    reduceInts(values, count, &part);
+    reduceMerge(ctx, &part);
+    return PIPELINE_OK;
+}
+
+typedef struct {
+    FILE     *fp;
+    long long count;
+} PrintTarget;
+
+static int printSink(void *ctx, const int *values, int count) {
+    PrintTarget *t = ctx;
+    for (int i = 0; i < count; i++)
+        fprintf(t->fp, "%d\n", values[i]);
+    t->count += count;
+    return PIPELINE_OK;
+}
+
+static int runTerminal(const Pipeline *p, View *v, Pending *pd, PipelineResult *r) {
+    switch (p->terminal) {
+    case TERM_PRINT:
+    case TERM_SAVE: {
+        PrintTarget t = { stdout, 0 };
+        if (p->terminal == TERM_SAVE && (t.fp = fopen(p->path, "w")) == NULL) {
+            printf("Could not open '%s' for writing.\n", p->path);
+            return PIPELINE_IO;
+        }
+        drain(v, pd, printSink, &t);
+        if (t.fp != stdout)
+            fclose(t.fp);
+        r->kind  = RESULT_NONE;
+        r->count = t.count;
+        return PIPELINE_OK;
+    }
+
+    case TERM_COLLECT: {
+        int rc = materialize(v, pd);
+        if (rc != PIPELINE_OK)
+            return rc;
+        r->kind = RESULT_VALUES;
+        datasetInit(&r->as.values);
+        r->as.values.data     = v->owned;
+        r->as.values.size     = v->size;
+        r->as.values.capacity = v->capacity;
+        datasetRewritten(&r->as.values, v->order);
+        r->count = v->size;
+        v->owned = NULL;  /* handed to the result */
+        return PIPELINE_OK;
+    }
+
+    case TERM_COUNT:
+        r->kind = RESULT_INT;
+        r->as.integer = 0;
+        drain(v, pd, countSink, &r->as.integer);
+        r->count = r->as.integer;
+        return PIPELINE_OK;
+
+    default:
+        break;
+    }
+
+    /* Every other terminal reads one merged reduction */
+    Reduction acc = { 0, 0, 0, 0, 0.0, 0.0 };
+    drain(v, pd, reduceSink, &acc);
+    r->count = acc.count;
+    if (p->terminal == TERM_SUM) {
+        r->kind = RESULT_INT;
+        r->as.integer = (acc.count > 0) ? acc.sum : 0;
+        return PIPELINE_OK;
+    }
+    if (acc.count == 0)
+        return PIPELINE_EMPTY;
+
+    switch (p->terminal) {
+    case TERM_MIN:     r->kind = RESULT_INT;  r->as.integer = acc.min;  break;
+    case TERM_MAX:     r->kind = RESULT_INT;  r->as.integer = acc.max;  break;
+    case TERM_AVERAGE: r->kind = RESULT_REAL; r->as.real    = acc.mean; break;
+    default:           r->kind = RESULT_STATS; r->as.stats  = acc;      break;
+    }
+    return PIPELINE_OK;
+}
+
+/* ============================
+ *   Spec Parsing
+ * ============================ */
+
+static int parseNumber(const char *tok, int *out) {
+    if (!tok)
+        return -1;
+    char *end;
+    errno = 0;
+    long v = strtol(tok, &end, 10);
+    if (end == tok || *end != '\0' || errno == ERANGE || v < INT_MIN || v > INT_MAX)
+        return -1;
+    *out = (int)v;
+    return 0;
+}
+
+static int parseComparison(const char *tok, Comparison *out) {
+    static const struct { const char *name; Comparison cmp; } table[] = {
+        { "<", CMP_LT }, { "<=", CMP_LE }, { ">", CMP_GT },
+        { ">=", CMP_GE }, { "==", CMP_EQ }, { "!=", CMP_NE }
+    };
+    for (size_t k = 0; tok && k < sizeof(table) / sizeof(table[0]); k++) {
+        if (strcmp(tok, table[k].name) == 0) {
+            *out = table[k].cmp;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Terminal named word, or -1 */
+static int terminalNamed(const char *word) {
+    static const struct { const char *name; Terminal term; } table[] = {
+        { "print", TERM_PRINT }, { "save", TERM_SAVE }, { "collect", TERM_COLLECT },
+        { "count", TERM_COUNT }, { "sum", TERM_SUM }, { "min", TERM_MIN },
+        { "max", TERM_MAX }, { "avg", TERM_AVERAGE }, { "average", TERM_AVERAGE },
+        { "stats", TERM_STATS }
+    };
+    for (size_t k = 0; k < sizeof(table) / sizeof(table[0]); k++) {
+        if (strcmp(word, table[k].name) == 0)
+            return (int)table[k].term;
+    }
+    return -1;
+}
+
+/* Parse one '|'-separated segment into p */
+static int parseSegment(char *seg, Pipeline *p, int last) {
+    char *save;
+    char *word = strtok_r(seg, " \t\r\n", &save);
+    char *arg1 = word ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    char *arg2 = arg1 ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    char *extra = arg2 ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    if (!word) {
+        printf("Pipeline: empty stage.\n");
+        return PIPELINE_BAD_SPEC;
+    }
+
+    int term = terminalNamed(word);
+    if (term >= 0) {
+        if (!last) {
+            printf("Pipeline: '%s' must be the last stage.\n", word);
+            return PIPELINE_BAD_SPEC;
+        }
+        int wantsPath = (term == TERM_SAVE);
+        if ((wantsPath && (!arg1 || arg2)) || (!wantsPath && arg1)) {
+            printf("Pipeline: usage is '%s'.\n", wantsPath ? "save FILE" : word);
+            return PIPELINE_BAD_SPEC;
+        }
+        if (wantsPath && strlen(arg1) >= PIPELINE_MAX_PATH) {
+            printf("Pipeline: file name too long.\n");
+            return PIPELINE_BAD_SPEC;
+        }
+        p->terminal = (Terminal)term;
+        if (wantsPath)
+            strcpy(p->path, arg1);
+        return PIPELINE_OK;
+    }
+
+    int rc;
+    if (strcmp(word, "filter") == 0) {
+        Comparison cmp;
+        int operand;
+        if (extra || parseComparison(arg1, &cmp) != 0 || parseNumber(arg2, &operand) != 0) {
+            printf("Pipeline: usage is 'filter <|<=|>|>=|==|!= N'.\n");
+            return PIPELINE_BAD_SPEC;
+        }
+        rc = pipelineAddFilter(p, cmp, operand);
+    } else if (strcmp(word, "sort") == 0) {
+        if (arg2 || (arg1 && strcmp(arg1, "asc") != 0 && strcmp(arg1, "desc") != 0)) {
+            printf("Pipeline: usage is 'sort [asc|desc]'.\n");
+            return PIPELINE_BAD_SPEC;
+        }
+        rc = pipelineAddSort(p, (arg1 && strcmp(arg1, "desc") == 0) ? SORT_DESCENDING
+                                                                   : SORT_ASCENDING);
+    } else if (strcmp(word, "take") == 0) {
+        int count;
+        if (arg2 || parseNumber(arg1, &count) != 0 || count < 0) {
+            printf("Pipeline: usage is 'take N' (N >= 0).\n");
+            return PIPELINE_BAD_SPEC;
+        }
+        rc = pipelineAddTake(p, count);
+    } else {
+        printf("Pipeline: unknown stage '%s'.\n", word);
+        return PIPELINE_BAD_SPEC;
+    }
+
+    if (rc != 0) {
+        printf("Pipeline: more than %d stages.\n", PIPELINE_MAX_STAGES);
+        return PIPELINE_BAD_SPEC;
+    }
+    return PIPELINE_OK;
+}
+
+static int addStage(Pipeline *p, Stage s) {
+    if (p->stageCount == PIPELINE_MAX_STAGES)
+        return -1;
+    p->stages[p->stageCount++] = s;
+    return 0;
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+void pipelineInit(Pipeline *p, Terminal terminal) {
+    p->stageCount = 0;
+    p->terminal   = terminal;
+    p->path[0]    = '\0';
+}
+
+int pipelineAddFilter(Pipeline *p, Comparison cmp, int operand) {
+    Stage s = { STAGE_FILTER, cmp, operand, SORT_ASCENDING };
+    return addStage(p, s);
+}
+
+int pipelineAddSort(Pipeline *p, SortOrder order) {
+    Stage s = { STAGE_SORT, CMP_EQ, 0, order };
+    return addStage(p, s);
+}
+
+int pipelineAddTake(Pipeline *p, int count) {
+    if (count < 0)
+        return -1;
+    Stage s = { STAGE_TAKE, CMP_EQ, count, SORT_ASCENDING };
+    return addStage(p, s);
+}
+
+int pipelineParse(const char *spec, Pipeline *p) {
+    pipelineInit(p, TERM_PRINT);
+    char *copy = strdup(spec);
+    if (!copy)
+        return PIPELINE_NO_MEMORY;
+
+    int rc = PIPELINE_OK;
+    char *seg = copy;
+    while (rc == PIPELINE_OK) {
+        char *bar = strchr(seg, '|');
+        if (bar)
+            *bar = '\0';
+        rc = parseSegment(seg, p, bar == NULL);
+        if (!bar)
+            break;
+        seg = bar + 1;
+    }
+    free(copy);
+    return rc;
+}
+
+int pipelineRun(const Pipeline *p, const Dataset *ds, PipelineResult *r) {
+    View v = { ds->data, ds->size, NULL, 0, ds->order };
+    Pending pd;
+    pd.filterCount = 0;
+    pd.limit       = -1;
+    r->kind  = RESULT_NONE;
+    r->count = 0;
+
+    int rc = PIPELINE_OK;
+    for (int k = 0; k < p->stageCount && rc == PIPELINE_OK; k++) {
+        const Stage *s = &p->stages[k];
+        switch (s->kind) {
+        case STAGE_FILTER:
+            /* A take already pending has to cut before this filter runs */
+            if (pd.limit >= 0)
+                rc = materialize(&v, &pd);
+            pd.filters[pd.filterCount++] = s;
+            break;
+
+        case STAGE_TAKE:
+            if (pd.filterCount == 0) {
+                if (s->operand < v.size)
+                    v.size = s->operand;
+            } else if (pd.limit < 0 || s->operand < pd.limit) {
+                pd.limit = s->operand;
+            }
+            break;
+
+        case STAGE_SORT: {
+            unsigned want = (s->order == SORT_ASCENDING) ? ORDER_ASCENDING : ORDER_DESCENDING;
+            if (v.order & want)
+                break;  /* filters and takes keep the order, so nothing to do */
+            rc = materialize(&v, &pd);
+            if (rc == PIPELINE_OK) {
+                sortInts(v.owned, v.size, s->order, 0);
+                v.order = want;
+            }
+            break;
+        }
+        }
+    }
+
+    if (rc == PIPELINE_OK)
+        rc = runTerminal(p, &v, &pd, r);
+    free(v.owned);
+    return rc;
+}
+
+void pipelinePrintResult(const PipelineResult *r) {
+    switch (r->kind) {
+    case RESULT_INT:
+        printf("%lld\n", r->as.integer);
+        break;
+    case RESULT_REAL:
+        printf("%.4f\n", r->as.real);
+        break;
+    case RESULT_STATS:
+        printf("count=%lld sum=%lld min=%d max=%d mean=%.4f variance=%.4f\n",
+               r->as.stats.count, r->as.stats.sum, r->as.stats.min,
+               r->as.stats.max, r->as.stats.mean, r->as.stats.variance);
+        break;
+    case RESULT_VALUES: {
+        PrintTarget t = { stdout, 0 };
+        printSink(&t, r->as.values.data, r->as.values.size);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void pipelineResultFree(PipelineResult *r) {
+    if (r->kind == RESULT_VALUES)
+        datasetFree(&r->as.values);
+    r->kind = RESULT_NONE;
+}
+
+const char *pipelineError(int rc) {
+    switch (rc) {
+    case PIPELINE_OK:        return "ok";
+    case PIPELINE_BAD_SPEC:  return "invalid pipeline";
+    case PIPELINE_NO_MEMORY: return "memory allocation failed";
+    case PIPELINE_EMPTY:     return "no values reached the terminal";
+    case PIPELINE_IO:        return "file could not be opened";
+    default:                 return "unknown error";
+    }
+}
+
+int pipelineRunScript(const char *filename, Dataset *ds) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Script '%s' not found.\n", filename);
+        return PIPELINE_IO;
+    }
+
+    char line[SCRIPT_LINE_MAX];
+    int lineNo = 0;
+    int rc = PIPELINE_OK;
+    while (rc == PIPELINE_OK && fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        if (!strchr(line, '\n') && !feof(fp)) {
+            printf("Line %d: longer than %d characters.\n", lineNo, SCRIPT_LINE_MAX - 2);
+            rc = PIPELINE_BAD_SPEC;
+            break;
+        }
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+        char *start = line + strspn(line, " \t\r\n");
+        if (*start == '\0')
+            continue;
+
+        /* "load FILE" swaps in a new dataset; a failed load keeps the old one */
+        if (strncmp(start, "load", 4) == 0 && strchr(" \t\r\n", start[4])) {
+            char *save;
+            char *file = strtok_r(start + 4, " \t\r\n", &save);
+            Dataset loaded;
+            long long skipped;
+            datasetInit(&loaded);
+            int prc = file ? parseIntegerFile(file, &loaded, &skipped) : INTPARSE_NO_FILE;
+            if (prc != INTPARSE_OK) {
+                datasetFree(&loaded);
+                rc = (prc == INTPARSE_NO_MEMORY) ? PIPELINE_NO_MEMORY : PIPELINE_IO;
+            } else {
+                datasetFree(ds);
+                *ds = loaded;
+            }
+        } else {
+            Pipeline p;
+            PipelineResult r;
+            rc = pipelineParse(start, &p);
+            if (rc == PIPELINE_OK)
+                rc = pipelineRun(&p, ds, &r);
+            if (rc == PIPELINE_OK) {
+                pipelinePrintResult(&r);
+                pipelineResultFree(&r);
+            }
+        }
+        if (rc != PIPELINE_OK)
+            printf("Line %d: %s; script stopped.\n", lineNo, pipelineError(rc));
+    }
+    fclose(fp);
+    return rc;
+}
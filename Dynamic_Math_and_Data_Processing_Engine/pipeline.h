@@ -0,0 +1,113 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "dataset.h"
+#include "intsort.h"
+#include "reduce.h"
+
+/*
+ * Operation pipelines
+ * -------------------
+ * A pipeline is a chain of stages ending in one terminal, e.g.
+ *     filter >= 10 | sort desc | take 5 | stats
+ * and returns a typed result instead of printing:
+ *  - it never modifies the dataset it runs on
+ *  - consecutive filters (and a following take) are fused into a single
+ *    pass that feeds the terminal directly; no copy is made unless a sort
+ *    needs one, and then the filters write straight into that copy
+ *  - a take right after a sort (or on the raw dataset) only shortens the
+ *    view, and reductions over an unfiltered view run the SIMD kernel on
+ *    the data in place
+ *  - pipelines come from code (pipelineInit + pipelineAdd*), from a text
+ *    spec (pipelineParse), or from a script file (pipelineRunScript)
+ */
+#define PIPELINE_MAX_STAGES 16
+#define PIPELINE_MAX_PATH   256
+
+#define PIPELINE_OK          0
+#define PIPELINE_BAD_SPEC   (-1)  /* unparsable spec or too many stages */
+#define PIPELINE_NO_MEMORY  (-2)
+#define PIPELINE_EMPTY      (-3)  /* min/max/avg/stats of no values */
+#define PIPELINE_IO         (-4)  /* a file could not be opened */
+
+typedef enum {
+    CMP_LT, CMP_LE, CMP_GT, CMP_GE, CMP_EQ, CMP_NE
+} Comparison;
+
+typedef enum {
+    STAGE_FILTER,  /* keep values where value <cmp> operand */
+    STAGE_SORT,
+    STAGE_TAKE     /* keep the first operand values */
+} StageKind;
+
+typedef struct {
+    StageKind  kind;
+    Comparison cmp;      /* filter */
+    int        operand;  /* filter: compared value; take: count */
+    SortOrder  order;    /* sort */
+} Stage;
+
+typedef enum {
+    TERM_PRINT,    /* values to stdout (the default terminal) */
+    TERM_SAVE,     /* values to path, one per line */
+    TERM_COLLECT,  /* values returned in the result */
+    TERM_COUNT,
+    TERM_SUM,
+    TERM_MIN,
+    TERM_MAX,
+    TERM_AVERAGE,
+    TERM_STATS
+} Terminal;
+
+typedef struct {
+    Stage    stages[PIPELINE_MAX_STAGES];
+    int      stageCount;
+    Terminal terminal;
+    char     path[PIPELINE_MAX_PATH];  /* TERM_SAVE */
+} Pipeline;
+
+typedef enum {
+    RESULT_NONE,    /* print, save */
+    RESULT_INT,     /* count, sum, min, max */
+    RESULT_REAL,    /* average */
+    RESULT_STATS,
+    RESULT_VALUES   /* collect */
+} ResultKind;
+
+typedef struct {
+    ResultKind kind;
+    long long  count;  /* values that reached the terminal */
+    union {
+        long long integer;
+        double    real;
+        Reduction stats;
+        Dataset   values;  /* released by pipelineResultFree */
+    } as;
+} PipelineResult;
+
+/* Building: the add functions return 0, or -1 once the pipeline is full */
+void pipelineInit(Pipeline *p, Terminal terminal);
+int  pipelineAddFilter(Pipeline *p, Comparison cmp, int operand);
+int  pipelineAddSort(Pipeline *p, SortOrder order);
+int  pipelineAddTake(Pipeline *p, int count);
+
+/* Parse "stage | stage | ... | terminal"; problems are reported on stdout */
+int  pipelineParse(const char *spec, Pipeline *p);
+
+/* Run p over ds; returns a PIPELINE_* code and fills r on success */
+int  pipelineRun(const Pipeline *p, const Dataset *ds, PipelineResult *r);
+
+void pipelinePrintResult(const PipelineResult *r);
+void pipelineResultFree(PipelineResult *r);
+
+/* Short description of a PIPELINE_* code */
+const char *pipelineError(int rc);
+
+/*
+ * Run a script: one spec per line, '#' starts a comment, and
+ * "load FILE" replaces ds with the integers in FILE. Stops at the first
+ * failing line. Returns a PIPELINE_* code.
+ */
+int  pipelineRunScript(const char *filename, Dataset *ds);
+
+#endif /* PIPELINE_H */
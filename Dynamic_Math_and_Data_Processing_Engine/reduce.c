@@ -0,0 +1,192 @@
+#include <limits.h>
+#include "reduce.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define REDUCE_X86 1
+#endif
+
+/* Running totals of one pass; kernels fold their lanes into this */
+typedef struct {
+    long long sum;
+    int       min;
+    int       max;
+    double    sumSq;  /* sum of (x - shift)^2 */
+} Partial;
+
+typedef void (*ReduceKernel)(const int *data, int size, double shift, Partial *p);
+
+/* ============================
+ *   Kernels
+ * ============================ */
+
+static void reduceScalar(const int *data, int size, double shift, Partial *p) {
+    long long sum = 0;
+    int min = p->min, max = p->max;
+    double sumSq = 0.0;
+    for (int i = 0; i < size; i++) {
+        int v = data[i];
+        double d = (double)v - shift;
+        sum += v;
+        min = (v < min) ? v : min;
+        max = (v > max) ? v : max;
+        sumSq += d * d;
+    }
+    p->sum   += sum;
+    p->min    = min;
+    p->max    = max;
+    p->sumSq += sumSq;
+}
+
+#ifdef REDUCE_X86
+
+/* Lanes are combined through memory; this runs once per call */
+static void foldLanes(const int *mins, const int *maxs, int lanes,
+                      const long long *sums, int sumLanes,
+                      const double *squares, int sqLanes, Partial *p) {
+    for (int k = 0; k < lanes; k++) {
+        if (mins[k] < p->min) p->min = mins[k];
+        if (maxs[k] > p->max) p->max = maxs[k];
+    }
+    for (int k = 0; k < sumLanes; k++)
+        p->sum += sums[k];
+    for (int k = 0; k < sqLanes; k++)
+        p->sumSq += squares[k];
+}
+
+__attribute__((target("sse4.1")))
+static void reduceSse41(const int *data, int size, double shift, Partial *p) {
+    __m128i vmin = _mm_set1_epi32(p->min), vmax = _mm_set1_epi32(p->max);
+    __m128i sumLo = _mm_setzero_si128(), sumHi = _mm_setzero_si128();
+    __m128d sqLo = _mm_setzero_pd(), sqHi = _mm_setzero_pd();
+    __m128d vshift = _mm_set1_pd(shift);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i v  = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i hi = _mm_unpackhi_epi64(v, v);
+        vmin  = _mm_min_epi32(vmin, v);
+        vmax  = _mm_max_epi32(vmax, v);
+        sumLo = _mm_add_epi64(sumLo, _mm_cvtepi32_epi64(v));
+        sumHi = _mm_add_epi64(sumHi, _mm_cvtepi32_epi64(hi));
+        __m128d dLo = _mm_sub_pd(_mm_cvtepi32_pd(v), vshift);
+        __m128d dHi = _mm_sub_pd(_mm_cvtepi32_pd(hi), vshift);
+        sqLo = _mm_add_pd(sqLo, _mm_mul_pd(dLo, dLo));
+        sqHi = _mm_add_pd(sqHi, _mm_mul_pd(dHi, dHi));
+    }
+
+    int mins[4], maxs[4];
+    long long sums[4];
+    double squares[4];
+    _mm_storeu_si128((__m128i *)mins, vmin);
+    _mm_storeu_si128((__m128i *)maxs, vmax);
+    _mm_storeu_si128((__m128i *)sums, sumLo);
+    _mm_storeu_si128((__m128i *)(sums + 2), sumHi);
+    _mm_storeu_pd(squares, sqLo);
+    _mm_storeu_pd(squares + 2, sqHi);
+    foldLanes(mins, maxs, 4, sums, 4, squares, 4, p);
+    reduceScalar(data + i, size - i, shift, p);
+}
+
+__attribute__((target("avx2")))
+static void reduceAvx2(const int *data, int size, double shift, Partial *p) {
+    __m256i vmin = _mm256_set1_epi32(p->min), vmax = _mm256_set1_epi32(p->max);
+    __m256i sumLo = _mm256_setzero_si256(), sumHi = _mm256_setzero_si256();
+    __m256d sqLo = _mm256_setzero_pd(), sqHi = _mm256_setzero_pd();
+    __m256d vshift = _mm256_set1_pd(shift);
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i v  = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m128i lo = _mm256_castsi256_si128(v);
+        __m128i hi = _mm256_extracti128_si256(v, 1);
+        vmin  = _mm256_min_epi32(vmin, v);
+        vmax  = _mm256_max_epi32(vmax, v);
+        sumLo = _mm256_add_epi64(sumLo, _mm256_cvtepi32_epi64(lo));
+        sumHi = _mm256_add_epi64(sumHi, _mm256_cvtepi32_epi64(hi));
+        __m256d dLo = _mm256_sub_pd(_mm256_cvtepi32_pd(lo), vshift);
+        __m256d dHi = _mm256_sub_pd(_mm256_cvtepi32_pd(hi), vshift);
+        sqLo = _mm256_add_pd(sqLo, _mm256_mul_pd(dLo, dLo));
+        sqHi = _mm256_add_pd(sqHi, _mm256_mul_pd(dHi, dHi));
+    }
+
+    int mins[8], maxs[8];
+    long long sums[8];
+    double squares[8];
+    _mm256_storeu_si256((__m256i *)mins, vmin);
+    _mm256_storeu_si256((__m256i *)maxs, vmax);
+    _mm256_storeu_si256((__m256i *)sums, sumLo);
+    _mm256_storeu_si256((__m256i *)(sums + 4), sumHi);
+    _mm256_storeu_pd(squares, sqLo);
+    _mm256_storeu_pd(squares + 4, sqHi);
+    foldLanes(mins, maxs, 8, sums, 8, squares, 8, p);
+    reduceScalar(data + i, size - i, shift, p);
+}
+
+#endif /* REDUCE_X86 */
+
+/* Best kernel for this CPU; __builtin_cpu_supports only reads a cached flag */
+static ReduceKernel selectKernel(const char **name) {
+#ifdef REDUCE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return reduceAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        *name = "sse4.1";
+        return reduceSse41;
+    }
+#endif
+    *name = "scalar";
+    return reduceScalar;
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+void reduceInts(const int *data, int size, Reduction *out) {
+    const char *name;
+    ReduceKernel kernel = selectKernel(&name);
+
+    /* Shifting by a value from the data keeps (x - shift)^2 near the spread */
+    double shift = data[0];
+    Partial p = { 0, INT_MAX, INT_MIN, 0.0 };
+    kernel(data, size, shift, &p);
+
+    out->count = size;
+    out->sum   = p.sum;
+    out->min   = p.min;
+    out->max   = p.max;
+    out->mean  = (double)p.sum / size;
+
+    /* Var = (sum (x-s)^2 - (sum (x-s))^2 / n) / n */
+    double shiftedSum = (double)(p.sum - (long long)data[0] * size);
+    double variance = (p.sumSq - shiftedSum * shiftedSum / size) / size;
+    out->variance = (variance > 0.0) ? variance : 0.0;
+}
+
+void reduceMerge(Reduction *into, const Reduction *part) {
+    if (part->count == 0)
+        return;
+    if (into->count == 0) {
+        *into = *part;
+        return;
+    }
+
+    /* Chan et al.: M2 = M2a + M2b + delta^2 * na * nb / n, with M2 = var * n */
+    double na = (double)into->count, nb = (double)part->count, n = na + nb;
+    double delta = part->mean - into->mean;
+    double m2 = into->variance * na + part->variance * nb + delta * delta * na * nb / n;
+
+    into->count += part->count;
+    into->sum   += part->sum;
+    into->min    = (part->min < into->min) ? part->min : into->min;
+    into->max    = (part->max > into->max) ? part->max : into->max;
+    into->mean   = (double)into->sum / (double)into->count;
+    into->variance = m2 / n;
+}
+
+const char *reduceKernelName(void) {
+    const char *name;
+    selectKernel(&name);
+    return name;
+}
@@ -0,0 +1,35 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+/*
+ * Fused reduction kernel
+ * ----------------------
+ * One pass over the dataset yields every summary statistic:
+ *  - the sum is accumulated in 64 bits, so it cannot overflow for any
+ *    dataset the engine can hold
+ *  - variance uses sums of squares shifted by the first value, which
+ *    keeps the floating-point cancellation small for clustered data
+ *  - the pass runs 8 values at a time with AVX2 or 4 with SSE4.1 when the
+ *    CPU has them (checked at runtime), otherwise a scalar loop
+ *  - reductions of separate pieces merge exactly (count, sum, min, max)
+ *    or with the pairwise variance update, so data can be reduced in chunks
+ */
+typedef struct {
+    long long count;
+    long long sum;
+    int       min;
+    int       max;
+    double    mean;
+    double    variance;  /* population variance */
+} Reduction;
+
+/* Reduce data[0..size); size must be > 0 */
+void reduceInts(const int *data, int size, Reduction *out);
+
+/* Fold part into into; a count of 0 on either side is the empty reduction */
+void reduceMerge(Reduction *into, const Reduction *part);
+
+/* Name of the kernel reduceInts uses on this CPU ("avx2", "sse4.1" or "scalar") */
+const char *reduceKernelName(void);
+
+#endif /* REDUCE_H */
@@ -0,0 +1,179 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "search.h"
+#include "intparse.h"
+#include "typed.h"
+
+#define INDEX_MIN_SLOTS 1024
+#define INDEX_KEY_BLOCK 1024  /* keys converted per typedEqualKeys call */
+
+typedef struct {
+    uint64_t key;    /* typedEqualKey of the value */
+    int      count;  /* 0: empty slot */
+    int      start;  /* first of this value's entries in positions[] */
+} IndexSlot;
+
+/* Lives in one block: the header, then the slots, then the positions */
+struct ValueIndex {
+    unsigned   mask;       /* slot count - 1 (a power of two) */
+    IndexSlot *slots;
+    int       *positions;  /* every index of data[], grouped by value */
+};
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+static unsigned hashKey(uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    return (unsigned)(h ^ (h >> 32));
+}
+
+/* Slot holding key, or the empty slot where it belongs (linear probing) */
+static IndexSlot *findSlot(IndexSlot *slots, unsigned mask, uint64_t key) {
+    unsigned i = hashKey(key) & mask;
+    while (slots[i].count != 0 && slots[i].key != key)
+        i = (i + 1) & mask;
+    return &slots[i];
+}
+
+/* Count every distinct value, doubling the table while it is over half full.
+   The values are turned into keys a block at a time, so the type is looked
+   at once per block. Returns the table (caller frees) and its mask, or
+   NULL if out of memory. */
+static IndexSlot *countValues(const Dataset *ds, unsigned *maskOut) {
+    unsigned mask = INDEX_MIN_SLOTS - 1;
+    IndexSlot *slots = calloc(mask + 1, sizeof(IndexSlot));
+    if (!slots)
+        return NULL;
+
+    uint64_t keys[INDEX_KEY_BLOCK];
+    unsigned distinct = 0;
+    for (int base = 0; base < ds->size; base += INDEX_KEY_BLOCK) {
+        int n = (ds->size - base < INDEX_KEY_BLOCK) ? ds->size - base : INDEX_KEY_BLOCK;
+        typedEqualKeys(ds, base, n, keys);
+        for (int i = 0; i < n; i++) {
+            IndexSlot *s = findSlot(slots, mask, keys[i]);
+            if (s->count++ > 0)
+                continue;
+            s->key = keys[i];
+            if (++distinct * 2 <= mask + 1)
+                continue;
+
+            unsigned bigger = mask * 2 + 1;
+            IndexSlot *grown = calloc(bigger + 1, sizeof(IndexSlot));
+            if (!grown) {
+                free(slots);
+                return NULL;
+            }
+            for (unsigned k = 0; k <= mask; k++) {
+                if (slots[k].count != 0)
+                    *findSlot(grown, bigger, slots[k].key) = slots[k];
+            }
+            free(slots);
+            slots = grown;
+            mask  = bigger;
+        }
+    }
+    *maskOut = mask;
+    return slots;
+}
+
+static ValueIndex *buildIndex(const Dataset *ds) {
+    unsigned mask;
+    IndexSlot *counted = countValues(ds, &mask);
+    if (!counted)
+        return NULL;
+
+    size_t slotBytes = (size_t)(mask + 1) * sizeof(IndexSlot);
+    ValueIndex *ix = malloc(sizeof(ValueIndex) + slotBytes + (size_t)ds->size * sizeof(int));
+    if (!ix) {
+        free(counted);
+        return NULL;
+    }
+    ix->mask      = mask;
+    ix->slots     = (IndexSlot *)(ix + 1);
+    ix->positions = (int *)((char *)ix->slots + slotBytes);
+    memcpy(ix->slots, counted, slotBytes);
+    free(counted);
+
+    /* Point each value at the end of its group, then fill backwards so
+       the group ends up ascending and start lands on its first entry */
+    int end = 0;
+    for (unsigned k = 0; k <= mask; k++) {
+        end += ix->slots[k].count;
+        ix->slots[k].start = end;
+    }
+    uint64_t keys[INDEX_KEY_BLOCK];
+    for (int top = ds->size; top > 0; top -= INDEX_KEY_BLOCK) {
+        int n = (top < INDEX_KEY_BLOCK) ? top : INDEX_KEY_BLOCK;
+        typedEqualKeys(ds, top - n, n, keys);
+        for (int i = n - 1; i >= 0; i--) {
+            IndexSlot *s = findSlot(ix->slots, mask, keys[i]);
+            ix->positions[--s->start] = top - n + i;
+        }
+    }
+    return ix;
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+int searchFind(Dataset *ds, const TypedValue *value, SearchMatch *m) {
+    m->count     = 0;
+    m->first     = 0;
+    m->positions = NULL;
+    if (ds->size == 0)
+        return 0;
+
+    if (ds->order != 0) {
+        m->count = typedFind(ds, value, &m->first, 1);  /* binary search */
+        return 0;
+    }
+
+    if (!ds->index && (ds->index = buildIndex(ds)) == NULL)
+        return -1;
+    const ValueIndex *ix = ds->index;
+    const IndexSlot *s = findSlot(ix->slots, ix->mask, typedEqualKey(ds->type, value));
+    m->count     = s->count;
+    m->positions = ix->positions + s->start;
+    return 0;
+}
+
+int searchMatchAt(const SearchMatch *m, int k) {
+    return m->positions ? m->positions[k] : m->first + k;
+}
+
+int searchBatch(Dataset *ds, const char *queryFile, FILE *out, BatchStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    Dataset queries;
+    long long skipped;
+    datasetInit(&queries);
+    int rc = parseIntegerFile(queryFile, &queries, &skipped);
+    if (rc != INTPARSE_OK) {
+        datasetFree(&queries);
+        return rc;
+    }
+
+    for (int q = 0; q < queries.size; q++) {
+        SearchMatch m;
+        TypedValue v;
+        v.i32 = queries.data[q];
+        if (searchFind(ds, &v, &m) != 0) {
+            rc = INTPARSE_NO_MEMORY;
+            break;
+        }
+        fprintf(out, "%d %d", queries.data[q], m.count);
+        for (int k = 0; k < m.count; k++)
+            fprintf(out, " %d", searchMatchAt(&m, k));
+        fprintf(out, "\n");
+
+        stats->queries++;
+        stats->found   += (m.count > 0);
+        stats->matches += m.count;
+    }
+    datasetFree(&queries);
+    return rc;
+}
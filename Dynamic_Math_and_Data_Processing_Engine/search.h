@@ -0,0 +1,47 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdio.h>
+#include "dataset.h"
+
+/*
+ * Value search
+ * ------------
+ * Finds every index holding a value:
+ *  - sorted data (ascending or descending, as tracked by the dataset)
+ *    uses two binary searches; the matches are one contiguous run
+ *  - otherwise a hash index is built on the first search (one pass to
+ *    count each distinct value, one to record positions) and kept until
+ *    the dataset changes, so every further lookup is O(1) plus its matches
+ *  - every value type is indexed, keyed by typedEqualKey (typed.c)
+ */
+
+/* Matches of one lookup; read them with searchMatchAt */
+typedef struct {
+    int        count;
+    int        first;      /* sorted data: the run starts here */
+    const int *positions;  /* indexed data: the count indices, ascending */
+} SearchMatch;
+
+/* Find value (of ds->type) in ds; m is valid until ds changes.
+   Returns 0, or -1 if the index could not be allocated. */
+int  searchFind(Dataset *ds, const TypedValue *value, SearchMatch *m);
+
+/* k-th matching index (0 <= k < m->count), in ascending order */
+int  searchMatchAt(const SearchMatch *m, int k);
+
+/* Totals of a batch lookup */
+typedef struct {
+    int       queries;
+    int       found;    /* queries with at least one match */
+    long long matches;  /* indices written */
+} BatchStats;
+
+/*
+ * Look up every integer in queryFile in an int32 ds and write one line per
+ * query to out: "value count index...". Returns an INTPARSE_* code (see
+ * intparse.h).
+ */
+int  searchBatch(Dataset *ds, const char *queryFile, FILE *out, BatchStats *stats);
+
+#endif /* SEARCH_H */
@@ -0,0 +1,286 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+#include "dataset.h"
+#include "intparse.h"
+
+#define MERGE_MIN_BUFFER 1024  /* values buffered per run, at least */
+
+/* A spilled run being merged: a window of it is buffered in memory */
+typedef struct {
+    FILE *fp;
+    int  *buf;
+    int   pos;
+    int   len;  /* 0 once the run is exhausted */
+} RunCursor;
+
+typedef struct {
+    FILE **files;
+    int    count;
+    int    capacity;
+} RunList;
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+/* Reader block for a budget. A block holds at most one value per two
+   bytes, so its values take up to 2x the block; the parser's buffers and
+   the sort scratch take as much again, which keeps the peak near 5 blocks */
+static size_t blockBytes(size_t memoryBytes) {
+    if (memoryBytes < STREAM_MIN_MEMORY)
+        memoryBytes = STREAM_MIN_MEMORY;
+    return memoryBytes / 6;
+}
+
+static int fromParse(int rc) {
+    if (rc == INTPARSE_NO_MEMORY)
+        return STREAM_NO_MEMORY;
+    return (rc == INTPARSE_OK) ? STREAM_OK : STREAM_NO_FILE;
+}
+
+static int pushRun(RunList *l, FILE *fp) {
+    if (l->count == l->capacity) {
+        int capacity = l->capacity ? l->capacity * 2 : 16;
+        FILE **tmp = realloc(l->files, (size_t)capacity * sizeof(FILE *));
+        if (!tmp)
+            return -1;
+        l->files = tmp;
+        l->capacity = capacity;
+    }
+    l->files[l->count++] = fp;
+    return 0;
+}
+
+static void closeRuns(RunList *l) {
+    for (int k = 0; k < l->count; k++)
+        fclose(l->files[k]);
+    free(l->files);
+    memset(l, 0, sizeof(*l));
+}
+
+/* Text (one per line, like saveDataToFile) for the final output,
+   raw ints for runs */
+static int writeValues(FILE *out, const int *values, int count, int text) {
+    if (!text)
+        return (fwrite(values, sizeof(int), (size_t)count, out) == (size_t)count) ? 0 : -1;
+    for (int i = 0; i < count; i++)
+        fprintf(out, "%d\n", values[i]);
+    return ferror(out) ? -1 : 0;
+}
+
+/* Write a sorted block to a new temporary file (removed when closed) */
+static int spill(const int *data, int size, RunList *runs) {
+    FILE *fp = tmpfile();
+    if (!fp)
+        return STREAM_IO;
+    if (writeValues(fp, data, size, 0) != 0 || fflush(fp) != 0) {
+        fclose(fp);
+        return STREAM_IO;
+    }
+    rewind(fp);
+    if (pushRun(runs, fp) != 0) {
+        fclose(fp);
+        return STREAM_NO_MEMORY;
+    }
+    return STREAM_OK;
+}
+
+static int refill(RunCursor *c, int capacity) {
+    c->len = (int)fread(c->buf, sizeof(int), (size_t)capacity, c->fp);
+    c->pos = 0;
+    return ferror(c->fp) ? -1 : 0;
+}
+
+static void siftDown(int *heap, int size, int i, const RunCursor *cur, int desc) {
+    for (;;) {
+        int best = i, l = 2 * i + 1, r = l + 1;
+        int bestHead = cur[heap[best]].buf[cur[heap[best]].pos];
+        if (l < size) {
+            int h = cur[heap[l]].buf[cur[heap[l]].pos];
+            if (desc ? h > bestHead : h < bestHead) { best = l; bestHead = h; }
+        }
+        if (r < size) {
+            int h = cur[heap[r]].buf[cur[heap[r]].pos];
+            if (desc ? h > bestHead : h < bestHead) best = r;
+        }
+        if (best == i)
+            return;
+        int tmp = heap[i];
+        heap[i] = heap[best];
+        heap[best] = tmp;
+        i = best;
+    }
+}
+
+/* Merge n sorted runs into out. The budget is split evenly between one
+   read buffer per run and the output buffer. */
+static int mergeRuns(FILE **in, int n, SortOrder order, size_t memoryBytes, FILE *out, int text) {
+    size_t per = memoryBytes / sizeof(int) / (size_t)(n + 1);
+    if (per < MERGE_MIN_BUFFER) per = MERGE_MIN_BUFFER;
+    if (per > INT_MAX) per = INT_MAX;
+    int bufValues = (int)per;
+
+    int *block = malloc((size_t)(n + 1) * per * sizeof(int));
+    RunCursor *cur = malloc((size_t)n * sizeof(RunCursor));
+    int *heap = malloc((size_t)n * sizeof(int));
+    if (!block || !cur || !heap) {
+        free(block);
+        free(cur);
+        free(heap);
+        return STREAM_NO_MEMORY;
+    }
+
+    int rc = STREAM_OK, heapSize = 0, outLen = 0;
+    int *outBuf = block + (size_t)n * per;
+    for (int k = 0; k < n; k++) {
+        cur[k].fp  = in[k];
+        cur[k].buf = block + (size_t)k * per;
+        if (refill(&cur[k], bufValues) != 0)
+            rc = STREAM_IO;
+        if (cur[k].len > 0)
+            heap[heapSize++] = k;
+    }
+
+    int desc = (order == SORT_DESCENDING);
+    for (int i = heapSize / 2 - 1; i >= 0; i--)
+        siftDown(heap, heapSize, i, cur, desc);
+
+    while (rc == STREAM_OK && heapSize > 0) {
+        RunCursor *c = &cur[heap[0]];
+        outBuf[outLen++] = c->buf[c->pos++];
+        if (outLen == bufValues) {
+            if (writeValues(out, outBuf, outLen, text) != 0)
+                rc = STREAM_IO;
+            outLen = 0;
+        }
+        if (c->pos == c->len) {
+            if (refill(c, bufValues) != 0)
+                rc = STREAM_IO;
+            if (c->len == 0)
+                heap[0] = heap[--heapSize];
+        }
+        if (heapSize > 0)
+            siftDown(heap, heapSize, 0, cur, desc);
+    }
+    if (rc == STREAM_OK && outLen > 0 && writeValues(out, outBuf, outLen, text) != 0)
+        rc = STREAM_IO;
+
+    free(block);
+    free(cur);
+    free(heap);
+    return rc;
+}
+
+/* Merge groups of STREAM_MAX_FANIN runs into longer runs until one final
+   merge can take them all */
+static int reduceRuns(RunList *runs, SortOrder order, size_t memoryBytes, int *passes) {
+    while (runs->count > STREAM_MAX_FANIN) {
+        RunList next = { NULL, 0, 0 };
+        int rc = STREAM_OK;
+        for (int k = 0; k < runs->count && rc == STREAM_OK; k += STREAM_MAX_FANIN) {
+            int n = runs->count - k;
+            if (n > STREAM_MAX_FANIN) n = STREAM_MAX_FANIN;
+            FILE *fp = tmpfile();
+            if (!fp) {
+                rc = STREAM_IO;
+                break;
+            }
+            rc = mergeRuns(runs->files + k, n, order, memoryBytes, fp, 0);
+            if (rc == STREAM_OK && fflush(fp) != 0)
+                rc = STREAM_IO;
+            rewind(fp);
+            if (pushRun(&next, fp) != 0) {
+                fclose(fp);
+                if (rc == STREAM_OK)
+                    rc = STREAM_NO_MEMORY;
+            }
+        }
+        closeRuns(runs);
+        *runs = next;
+        (*passes)++;
+        if (rc != STREAM_OK)
+            return rc;
+    }
+    return STREAM_OK;
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+int streamReduce(const char *filename, size_t memoryBytes, Reduction *out, StreamStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    memset(out, 0, sizeof(*out));
+    IntReader r;
+    int rc = fromParse(intReaderOpen(&r, filename, blockBytes(memoryBytes)));
+    if (rc != STREAM_OK)
+        return rc;
+
+    Dataset chunk;
+    datasetInit(&chunk);
+    while ((rc = fromParse(intReaderNext(&r, &chunk))) == STREAM_OK && chunk.size > 0) {
+        Reduction part;
+        reduceInts(chunk.data, chunk.size, &part);
+        reduceMerge(out, &part);
+    }
+    stats->values  = out->count;
+    stats->skipped = r.errors;
+    datasetFree(&chunk);
+    intReaderClose(&r);
+    return rc;
+}
+
+int streamSort(const char *filename, const char *outFile, SortOrder order,
+               size_t memoryBytes, StreamStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (memoryBytes < STREAM_MIN_MEMORY)
+        memoryBytes = STREAM_MIN_MEMORY;
+    IntReader r;
+    int rc = fromParse(intReaderOpen(&r, filename, blockBytes(memoryBytes)));
+    if (rc != STREAM_OK)
+        return rc;
+
+    /* Run formation: each block is sorted in memory and spilled */
+    Dataset chunk;
+    RunList runs = { NULL, 0, 0 };
+    int inMemory = 0;
+    datasetInit(&chunk);
+    while ((rc = fromParse(intReaderNext(&r, &chunk))) == STREAM_OK && chunk.size > 0) {
+        sortInts(chunk.data, chunk.size, order, 0);
+        stats->values += chunk.size;
+        if (runs.count == 0 && r.eof && r.have == 0) {
+            inMemory = 1;  /* the whole input was one block */
+            break;
+        }
+        if ((rc = spill(chunk.data, chunk.size, &runs)) != STREAM_OK)
+            break;
+    }
+    stats->skipped = r.errors;
+    intReaderClose(&r);
+    if (!inMemory)
+        datasetFree(&chunk);  /* the merge gets the whole budget */
+
+    stats->runs = runs.count;
+    if (rc == STREAM_OK)
+        rc = reduceRuns(&runs, order, memoryBytes, &stats->passes);
+
+    /* The output is opened last, so outFile may be the input itself */
+    FILE *out = NULL;
+    if (rc == STREAM_OK && (out = fopen(outFile, "w")) == NULL)
+        rc = STREAM_IO;
+    if (rc == STREAM_OK && inMemory) {
+        rc = (writeValues(out, chunk.data, chunk.size, 1) == 0) ? STREAM_OK : STREAM_IO;
+    } else if (rc == STREAM_OK && runs.count > 0) {
+        rc = mergeRuns(runs.files, runs.count, order, memoryBytes, out, 1);
+        stats->passes++;
+    }
+    if (out && fclose(out) != 0 && rc == STREAM_OK)
+        rc = STREAM_IO;
+
+    datasetFree(&chunk);
+    closeRuns(&runs);
+    return rc;
+}
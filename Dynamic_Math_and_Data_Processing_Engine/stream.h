@@ -0,0 +1,44 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include "intsort.h"
+#include "reduce.h"
+
+/*
+ * Out-of-core streaming
+ * ---------------------
+ * Processes an input.txt-style file without loading it, within a memory
+ * budget, so inputs may be larger than RAM:
+ *  - the file is parsed one block at a time (IntReader in intparse.c)
+ *  - reductions run per block and are merged (reduceMerge)
+ *  - sorting is an external merge sort: each block is radix-sorted and
+ *    spilled to a temporary file as a run, then the runs are merged
+ *    through a heap, at most STREAM_MAX_FANIN at a time; more runs than
+ *    that are merged in several passes
+ *  - an input that fits in one block is sorted in memory, with no spill
+ */
+#define STREAM_OK          0
+#define STREAM_NO_FILE    (-1)  /* input could not be read */
+#define STREAM_NO_MEMORY  (-2)
+#define STREAM_IO         (-3)  /* a spill or output file failed */
+
+#define STREAM_DEFAULT_MEMORY ((size_t)64 << 20)
+#define STREAM_MIN_MEMORY     ((size_t)1 << 20)
+#define STREAM_MAX_FANIN      64
+
+typedef struct {
+    long long values;
+    long long skipped;  /* malformed tokens */
+    int       runs;     /* runs spilled (0: sorted in memory) */
+    int       passes;   /* merge passes over the spilled data */
+} StreamStats;
+
+/* Reduce every integer in filename; out->count is 0 for an empty file */
+int streamReduce(const char *filename, size_t memoryBytes, Reduction *out, StreamStats *stats);
+
+/* Write filename's integers to outFile, one per line, in order */
+int streamSort(const char *filename, const char *outFile, SortOrder order,
+               size_t memoryBytes, StreamStats *stats);
+
+#endif /* STREAM_H */
@@ -0,0 +1,367 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "typed.h"
+#include "intparse.h"
+#include "reduce.h"
+
+#define STATS_CANCEL_LIMIT 1024.0  /* cancellation that forces a recompute */
+
+/* ============================
+ *   Kernel Instances
+ * ============================ */
+
+#define KT      int
+#define KS      I32
+#define KKEY    uint32_t
+#define KVAL    i32
+#define KFLOAT  0
+#define KMIN    INT_MIN
+#define KMAX    INT_MAX
+#define KFMT    "%d"
+#include "typedkernels.h"
+
+#define KT      int64_t
+#define KS      I64
+#define KKEY    uint64_t
+#define KVAL    i64
+#define KFLOAT  0
+#define KMIN    INT64_MIN
+#define KMAX    INT64_MAX
+#define KFMT    "%" PRId64
+#include "typedkernels.h"
+
+#define KT      float
+#define KS      F32
+#define KKEY    uint32_t
+#define KVAL    f32
+#define KFLOAT  1
+#define KDIGITS 9
+#define KSTRTO  strtof
+#include "typedkernels.h"
+
+#define KT      double
+#define KS      F64
+#define KKEY    uint64_t
+#define KVAL    f64
+#define KFLOAT  1
+#define KDIGITS 17
+#define KSTRTO  strtod
+#include "typedkernels.h"
+
+static const struct {
+    const char *name;
+    size_t      size;
+} typeInfo[] = {
+    [TYPE_I32] = { "int32",  sizeof(int)     },
+    [TYPE_I64] = { "int64",  sizeof(int64_t) },
+    [TYPE_F32] = { "float",  sizeof(float)   },
+    [TYPE_F64] = { "double", sizeof(double)  },
+};
+
+/* ============================
+ *   Internal Helpers
+ * ============================ */
+
+static void reduceRaw(ValueType type, const void *data, int size, TypedStats *out) {
+    switch (type) {
+    case TYPE_I32: {
+        Reduction r;
+        reduceInts(data, size, &r);  /* the SIMD kernel */
+        out->count    = r.count;
+        out->isum     = r.sum;
+        out->fsum     = (double)r.sum;
+        out->min.i32  = r.min;
+        out->max.i32  = r.max;
+        out->mean     = r.mean;
+        out->variance = r.variance;
+        break;
+    }
+    case TYPE_I64: reduceValuesI64(data, size, out); break;
+    case TYPE_F32: reduceValuesF32(data, size, out); break;
+    default:       reduceValuesF64(data, size, out); break;
+    }
+}
+
+/* The reduction of the single value at p, without a pass */
+static void singleStats(ValueType type, const void *p, TypedStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->count = 1;
+    switch (type) {
+    case TYPE_I32: out->min.i32 = *(const int *)p;     out->isum = out->min.i32; break;
+    case TYPE_I64: out->min.i64 = *(const int64_t *)p; out->isum = out->min.i64; break;
+    case TYPE_F32: out->min.f32 = *(const float *)p;   out->fsum = out->min.f32; break;
+    default:       out->min.f64 = *(const double *)p;  out->fsum = out->min.f64; break;
+    }
+    if (type == TYPE_I32 || type == TYPE_I64)
+        out->fsum = (double)out->isum;
+    out->max  = out->min;
+    out->mean = out->fsum;
+}
+
+static int lessThan(ValueType type, const TypedValue *a, const TypedValue *b) {
+    switch (type) {
+    case TYPE_I32: return a->i32 < b->i32;
+    case TYPE_I64: return a->i64 < b->i64;
+    case TYPE_F32: return a->f32 < b->f32;
+    default:       return a->f64 < b->f64;
+    }
+}
+
+/* Fold a block's reduction into ds->stats (Chan et al., as in reduceMerge,
+   but around the running shift so no mean has to be recomputed) */
+static void mergeStats(Dataset *ds, const TypedStats *b) {
+    RunningStats *rs = &ds->stats;
+    if (ds->size == 0) {
+        rs->shift = b->mean;
+        rs->min   = b->min;
+        rs->max   = b->max;
+    } else if (rs->extremaKnown) {
+        if (lessThan(ds->type, &b->min, &rs->min)) rs->min = b->min;
+        if (lessThan(ds->type, &rs->max, &b->max)) rs->max = b->max;
+    }
+    double n = (double)b->count;
+    double d = b->mean - rs->shift;
+    rs->isum       += b->isum;
+    rs->fsum       += b->fsum;
+    rs->shiftedSum += n * d;
+    rs->shiftedSq  += n * (b->variance + d * d);
+}
+
+/* ============================
+ *   Public API
+ * ============================ */
+
+size_t valueSize(ValueType type) {
+    return typeInfo[type].size;
+}
+
+const char *valueTypeName(ValueType type) {
+    return typeInfo[type].name;
+}
+
+int valueTypeFromName(const char *name, ValueType *out) {
+    for (int t = TYPE_I32; t <= TYPE_F64; t++) {
+        if (strcmp(name, typeInfo[t].name) == 0) {
+            *out = (ValueType)t;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int typedParse(ValueType type, const char *tok, TypedValue *out, const char **reason) {
+    switch (type) {
+    case TYPE_I32: return parseTokenI32(tok, &out->i32, reason);
+    case TYPE_I64: return parseTokenI64(tok, &out->i64, reason);
+    case TYPE_F32: return parseTokenF32(tok, &out->f32, reason);
+    default:       return parseTokenF64(tok, &out->f64, reason);
+    }
+}
+
+void typedFormat(ValueType type, const TypedValue *v, char *buf, size_t n) {
+    switch (type) {
+    case TYPE_I32: formatValueI32(v->i32, buf, n); break;
+    case TYPE_I64: formatValueI64(v->i64, buf, n); break;
+    case TYPE_F32: formatValueF32(v->f32, buf, n); break;
+    default:       formatValueF64(v->f64, buf, n); break;
+    }
+}
+
+void typedFormatSum(ValueType type, const TypedStats *s, char *buf, size_t n) {
+    if (type == TYPE_F32 || type == TYPE_F64) {
+        formatValueF64(s->fsum, buf, n);
+        return;
+    }
+    if (s->isum >= INT64_MIN && s->isum <= INT64_MAX) {
+        snprintf(buf, n, "%" PRId64, (int64_t)s->isum);
+        return;
+    }
+
+    /* Beyond 64 bits: peel off decimal digits by hand */
+    char digits[TYPED_TEXT_MAX];
+    int len = 0;
+    WideInt v = s->isum;
+    int neg = (v < 0);
+    do {
+        int d = (int)(v % 10);
+        digits[len++] = (char)('0' + (neg ? -d : d));
+        v /= 10;
+    } while (v != 0);
+    size_t k = 0;
+    if (neg && k + 1 < n)
+        buf[k++] = '-';
+    while (len > 0 && k + 1 < n)
+        buf[k++] = digits[--len];
+    buf[k] = '\0';
+}
+
+void typedNoteAppend(Dataset *ds, const void *values, int count) {
+    if (count <= 0)
+        return;
+    int last = ds->size - 1;
+    TypedStats block;
+    switch (ds->type) {
+    case TYPE_I32:
+        ds->order = orderAfterI32(values, count, (last >= 0) ? &ds->data[last] : NULL, ds->order);
+        break;
+    case TYPE_I64:
+        ds->order = orderAfterI64(values, count, (last >= 0) ? &ds->i64[last] : NULL, ds->order);
+        break;
+    case TYPE_F32:
+        ds->order = orderAfterF32(values, count, (last >= 0) ? &ds->f32[last] : NULL, ds->order);
+        break;
+    default:
+        ds->order = orderAfterF64(values, count, (last >= 0) ? &ds->f64[last] : NULL, ds->order);
+        break;
+    }
+    if (count == 1)
+        singleStats(ds->type, values, &block);
+    else
+        reduceRaw(ds->type, values, count, &block);
+    mergeStats(ds, &block);
+}
+
+void typedNoteRemove(Dataset *ds, int index) {
+    RunningStats *rs = &ds->stats;
+    if (ds->size == 1) {
+        memset(rs, 0, sizeof(*rs));
+        rs->sumsKnown = rs->extremaKnown = 1;  /* empty again */
+        return;
+    }
+
+    TypedStats v;
+    singleStats(ds->type, (const char *)ds->raw + (size_t)index * valueSize(ds->type), &v);
+    rs->isum -= v.isum;
+    rs->fsum -= v.fsum;
+    double d = v.mean - rs->shift;
+    rs->shiftedSum -= d;
+    rs->shiftedSq  -= d * d;
+    /* Removing a term that dwarfs the rest leaves mostly rounding error:
+       recompute from the data at the next query instead */
+    if (d * d > STATS_CANCEL_LIMIT * rs->shiftedSq)
+        rs->sumsKnown = 0;
+    /* Only losing an extreme costs anything, and only at the next query */
+    if (!lessThan(ds->type, &rs->min, &v.min) || !lessThan(ds->type, &v.max, &rs->max))
+        rs->extremaKnown = 0;
+}
+
+void typedStats(Dataset *ds, TypedStats *out) {
+    RunningStats *rs = &ds->stats;
+    if (rs->sumsKnown && !rs->extremaKnown && ds->order != 0) {
+        /* Sorted: the extremes are at the ends */
+        size_t width = valueSize(ds->type);
+        const char *first = ds->raw, *last = first + (size_t)(ds->size - 1) * width;
+        int desc = !(ds->order & ORDER_ASCENDING);
+        memcpy(&rs->min, desc ? last : first, width);
+        memcpy(&rs->max, desc ? first : last, width);
+        rs->extremaKnown = 1;
+    }
+    double n = (double)ds->size;
+    double offset = rs->shiftedSum * rs->shiftedSum / n;
+    if (rs->sumsKnown &&
+        (!isfinite(offset) || isnan(rs->shiftedSq) ||
+         (isfinite(rs->shiftedSq) && offset > STATS_CANCEL_LIMIT * (rs->shiftedSq - offset))))
+        rs->sumsKnown = 0;  /* the mean moved far from the shift, or a sum overflowed: re-center */
+    if (!rs->sumsKnown || !rs->extremaKnown) {
+        typedReduce(ds, out);
+        rs->isum  = out->isum;
+        rs->fsum  = out->fsum;
+        rs->min   = out->min;
+        rs->max   = out->max;
+        rs->shift      = out->mean;  /* also clears drift from deletes */
+        rs->shiftedSum = 0.0;
+        rs->shiftedSq  = out->variance * (double)out->count;
+        rs->sumsKnown = rs->extremaKnown = 1;
+        return;
+    }
+
+    double variance = (rs->shiftedSq - offset) / n;
+    out->count    = ds->size;
+    out->isum     = rs->isum;
+    out->fsum     = (ds->type == TYPE_I32 || ds->type == TYPE_I64) ? (double)rs->isum : rs->fsum;
+    out->min      = rs->min;
+    out->max      = rs->max;
+    out->mean     = out->fsum / n;
+    out->variance = (variance < 0.0) ? 0.0 : variance;  /* an overflow stays inf */
+}
+
+int typedLoadFile(const char *filename, Dataset *ds, long long *errors) {
+    if (ds->type == TYPE_I32)
+        return parseIntegerFile(filename, ds, errors);
+
+    *errors = 0;
+    FILE *fp = fopen(filename, "r");
+    if (!fp)
+        return INTPARSE_NO_FILE;
+    int shown = 0, rc;
+    switch (ds->type) {
+    case TYPE_I64: rc = loadValuesI64(fp, ds, errors, &shown); break;
+    case TYPE_F32: rc = loadValuesF32(fp, ds, errors, &shown); break;
+    default:       rc = loadValuesF64(fp, ds, errors, &shown); break;
+    }
+    fclose(fp);
+    if (*errors > shown)
+        printf("... %lld more malformed token(s) skipped.\n", *errors - shown);
+    return rc;
+}
+
+int typedWrite(FILE *fp, const Dataset *ds, const char *sep) {
+    switch (ds->type) {
+    case TYPE_I32: return writeValuesI32(fp, ds->data, ds->size, sep);
+    case TYPE_I64: return writeValuesI64(fp, ds->i64, ds->size, sep);
+    case TYPE_F32: return writeValuesF32(fp, ds->f32, ds->size, sep);
+    default:       return writeValuesF64(fp, ds->f64, ds->size, sep);
+    }
+}
+
+void typedEqualKeys(const Dataset *ds, int start, int count, uint64_t *keys) {
+    switch (ds->type) {
+    case TYPE_I32: equalKeysI32(ds->data + start, count, keys); break;
+    case TYPE_I64: equalKeysI64(ds->i64 + start, count, keys); break;
+    case TYPE_F32: equalKeysF32(ds->f32 + start, count, keys); break;
+    default:       equalKeysF64(ds->f64 + start, count, keys); break;
+    }
+}
+
+uint64_t typedEqualKey(ValueType type, const TypedValue *v) {
+    switch (type) {
+    case TYPE_I32: return equalKeyI32(v->i32);
+    case TYPE_I64: return equalKeyI64(v->i64);
+    case TYPE_F32: return equalKeyF32(v->f32);
+    default:       return equalKeyF64(v->f64);
+    }
+}
+
+void typedReduce(const Dataset *ds, TypedStats *out) {
+    reduceRaw(ds->type, ds->raw, ds->size, out);
+}
+
+void typedSort(Dataset *ds, SortOrder order) {
+    switch (ds->type) {
+    case TYPE_I32: sortInts(ds->data, ds->size, order, 0); break;  /* parallel radix */
+    case TYPE_I64: sortValuesI64(ds->i64, ds->size, order); break;
+    case TYPE_F32: sortValuesF32(ds->f32, ds->size, order); break;
+    default:       sortValuesF64(ds->f64, ds->size, order); break;
+    }
+    datasetReordered(ds, (order == SORT_ASCENDING) ? ORDER_ASCENDING : ORDER_DESCENDING);
+}
+
+int typedFind(const Dataset *ds, const TypedValue *v, int *positions, int maxPositions) {
+    switch (ds->type) {
+    case TYPE_I32:
+        return findValuesI32(ds->data, ds->size, ds->order, v->i32, positions, maxPositions);
+    case TYPE_I64:
+        return findValuesI64(ds->i64, ds->size, ds->order, v->i64, positions, maxPositions);
+    case TYPE_F32:
+        return findValuesF32(ds->f32, ds->size, ds->order, v->f32, positions, maxPositions);
+    default:
+        return findValuesF64(ds->f64, ds->size, ds->order, v->f64, positions, maxPositions);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef TYPED_H
+#define TYPED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "dataset.h"
+#include "intsort.h"
+
+/*
+ * Typed kernels
+ * -------------
+ * Every operation on int32, int64, float and double datasets:
+ *  - the kernels are written once (typedkernels.h) and compiled once per
+ *    type, so each type runs a loop specialized for its own values; the
+ *    type is looked at once per call, never per element
+ *  - int32 keeps its dedicated paths: the parallel parser (intparse.c),
+ *    the SIMD reduction (reduce.c) and the parallel radix sort (intsort.c)
+ *  - integer sums are exact (128-bit); float and double sums use double
+ *  - the other types sort with the same LSD radix scheme on keys of
+ *    their own width (floats mapped so the key order is numeric order)
+ *  - NaN is rejected when parsing, so every value compares
+ *  - adds, deletes and loads keep running sums in the dataset, so the
+ *    statistics cost O(1) (see typedStats)
+ */
+
+typedef struct {
+    long long  count;
+    WideInt    isum;      /* integer types */
+    double     fsum;      /* float and double */
+    TypedValue min;
+    TypedValue max;
+    double     mean;
+    double     variance;  /* population variance */
+} TypedStats;
+
+#define TYPED_TEXT_MAX 48  /* room for any formatted value or sum */
+
+/* Bytes per value, and the names used by the menu ("int32", "int64", ...) */
+size_t      valueSize(ValueType type);
+const char *valueTypeName(ValueType type);
+int         valueTypeFromName(const char *name, ValueType *out);
+
+/* Parse one token as type. Returns 0, or -1 with *reason set. */
+int  typedParse(ValueType type, const char *tok, TypedValue *out, const char **reason);
+/* Format a value; floats get the shortest text that reads back exactly */
+void typedFormat(ValueType type, const TypedValue *v, char *buf, size_t n);
+/* Format a reduction's sum (exact for integer types) */
+void typedFormatSum(ValueType type, const TypedStats *s, char *buf, size_t n);
+
+/* Hooks for dataset.c, called before the change: fold values[0..count)
+   (or the value at index) into ds->order and ds->stats */
+void typedNoteAppend(Dataset *ds, const void *values, int count);
+void typedNoteRemove(Dataset *ds, int index);
+
+/* Statistics of ds (size > 0) from its running aggregates: O(1), except
+   that min/max (after deleting one of them, unless ds is sorted) or
+   everything (after datasetRewritten, or a delete that cancelled most of
+   the sum of squares) is recomputed in one pass first */
+void typedStats(Dataset *ds, TypedStats *out);
+
+/* Append filename's values (as ds->type) to ds; INTPARSE_* codes */
+int  typedLoadFile(const char *filename, Dataset *ds, long long *errors);
+/* Write every value followed by sep; returns 0, or -1 on a write error */
+int  typedWrite(FILE *fp, const Dataset *ds, const char *sep);
+
+/* Hash keys of data[start..start+count), and of one value: equal values,
+   and only those, get equal keys (search.c's index) */
+void     typedEqualKeys(const Dataset *ds, int start, int count, uint64_t *keys);
+uint64_t typedEqualKey(ValueType type, const TypedValue *v);
+
+/* Reduce ds in one full pass; ds->size must be > 0 */
+void typedReduce(const Dataset *ds, TypedStats *out);
+/* Sort in place and record the new order */
+void typedSort(Dataset *ds, SortOrder order);
+/* Count matches of v, storing the first maxPositions indices (ascending);
+   binary search when ds is sorted, a scan otherwise */
+int  typedFind(const Dataset *ds, const TypedValue *v, int *positions, int maxPositions);
+
+#endif /* TYPED_H */
@@ -0,0 +1,310 @@
+/*
+ * Typed kernel template
+ * ---------------------
+ * No include guard: typed.c includes this once per value type, after
+ * defining
+ *   KT      the value type             KS     its name suffix (I64, F32, ...)
+ *   KKEY    unsigned key of KT's width KVAL   its TypedValue member
+ *   KFLOAT  1 for floating point       KDIGITS  max significant digits
+ *   KMIN/KMAX, KFMT  integer range and printf format (integers only)
+ *   KSTRTO  strtof or strtod (floating point only)
+ * Every function is static inline and named <name><KS>, so each type gets
+ * its own copy with the element type known to the compiler. The
+ * parameters are undefined again at the end.
+ */
+#define KCAT_(a, b) a##b
+#define KCAT(a, b)  KCAT_(a, b)
+#define KFN(name)   KCAT(name, KS)
+
+#define KRADIX_BITS    11
+#define KRADIX_BUCKETS (1 << KRADIX_BITS)
+#define KRADIX_PASSES  ((int)((sizeof(KKEY) * 8 + KRADIX_BITS - 1) / KRADIX_BITS))
+
+/* Order bits that still hold after appending values[0..count) behind *last */
+static inline unsigned KFN(orderAfter)(const KT *values, int count, const KT *last, unsigned order) {
+    KT prev = last ? *last : values[0];
+    for (int i = 0; i < count && order != 0; i++) {
+        if (values[i] < prev) order &= ~ORDER_ASCENDING;
+        if (values[i] > prev) order &= ~ORDER_DESCENDING;
+        prev = values[i];
+    }
+    return order;
+}
+
+/* Unsigned key whose order is v's numeric order */
+static inline KKEY KFN(keyOf)(KT v) {
+    const KKEY sign = (KKEY)1 << (sizeof(KKEY) * 8 - 1);
+#if KFLOAT
+    KKEY bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & sign) ? ~bits : (bits | sign);
+#else
+    return (KKEY)v ^ sign;
+#endif
+}
+
+static inline int KFN(compareAsc)(const void *a, const void *b) {
+    KKEY x = KFN(keyOf)(*(const KT *)a), y = KFN(keyOf)(*(const KT *)b);
+    return (x > y) - (x < y);
+}
+
+static inline int KFN(compareDesc)(const void *a, const void *b) {
+    return KFN(compareAsc)(b, a);
+}
+
+/* LSD radix sort on the keys (flipped for descending), like intsort.c:
+   all digit histograms come from one read, and a pass whose digit is the
+   same for every value is skipped */
+static inline void KFN(sortValues)(KT *data, int size, SortOrder order) {
+    const KKEY flip = (order == SORT_DESCENDING) ? (KKEY)~(KKEY)0 : 0;
+    if (size < 64) {
+        for (int i = 1; i < size; i++) {
+            KT v = data[i];
+            KKEY k = KFN(keyOf)(v) ^ flip;
+            int j = i - 1;
+            while (j >= 0 && (KFN(keyOf)(data[j]) ^ flip) > k) {
+                data[j + 1] = data[j];
+                j--;
+            }
+            data[j + 1] = v;
+        }
+        return;
+    }
+
+    KT *tmp = malloc((size_t)size * sizeof(KT));
+    if (!tmp) {
+        qsort(data, (size_t)size, sizeof(KT),
+              (order == SORT_DESCENDING) ? KFN(compareDesc) : KFN(compareAsc));
+        return;
+    }
+
+    int counts[KRADIX_PASSES][KRADIX_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < size; i++) {
+        KKEY k = KFN(keyOf)(data[i]) ^ flip;
+        for (int p = 0; p < KRADIX_PASSES; p++)
+            counts[p][(k >> (p * KRADIX_BITS)) & (KRADIX_BUCKETS - 1)]++;
+    }
+
+    KT *src = data, *dst = tmp;
+    for (int p = 0; p < KRADIX_PASSES; p++) {
+        int *count = counts[p];
+        int shift = p * KRADIX_BITS;
+        if (count[((KFN(keyOf)(src[0]) ^ flip) >> shift) & (KRADIX_BUCKETS - 1)] == size)
+            continue;
+        int offset = 0;
+        for (int b = 0; b < KRADIX_BUCKETS; b++) {
+            int c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (int i = 0; i < size; i++) {
+            KT v = src[i];
+            dst[count[((KFN(keyOf)(v) ^ flip) >> shift) & (KRADIX_BUCKETS - 1)]++] = v;
+        }
+        KT *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != data)
+        memcpy(data, src, (size_t)size * sizeof(KT));
+    free(tmp);
+}
+
+/* One pass: sum, min, max and the shifted sums for the variance */
+static inline void KFN(reduceValues)(const KT *data, int size, TypedStats *out) {
+    KT min = data[0], max = data[0];
+    double shift = (double)data[0], shifted = 0.0, sumSq = 0.0;
+#if KFLOAT
+    double sum = 0.0;
+#else
+    WideInt sum = 0;
+#endif
+    for (int i = 0; i < size; i++) {
+        KT v = data[i];
+        double d = (double)v - shift;
+        sum += v;
+        min = (v < min) ? v : min;
+        max = (v > max) ? v : max;
+        shifted += d;
+        sumSq   += d * d;
+    }
+
+    out->count    = size;
+    out->min.KVAL = min;
+    out->max.KVAL = max;
+#if KFLOAT
+    out->isum = 0;
+    out->fsum = sum;
+#else
+    out->isum = sum;
+    out->fsum = (double)sum;
+#endif
+    out->mean = out->fsum / size;
+    double variance = (sumSq - shifted * shifted / size) / size;
+    if (variance != variance)
+        variance = sumSq;  /* squares past DBL_MAX (inf - inf): it overflows */
+    out->variance = (variance < 0.0) ? 0.0 : variance;
+}
+
+/* Hash key of v: equal values, and only those, get equal keys (-0.0 is
+   folded into 0.0 first; NaN never gets this far) */
+static inline uint64_t KFN(equalKey)(KT v) {
+#if KFLOAT
+    KKEY bits;
+    if (v == 0)
+        v = 0;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+#else
+    return (KKEY)v;
+#endif
+}
+
+static inline void KFN(equalKeys)(const KT *data, int count, uint64_t *keys) {
+    for (int i = 0; i < count; i++)
+        keys[i] = KFN(equalKey)(data[i]);
+}
+
+/* First index of sorted data past value (strictly if after), in the
+   data's own direction */
+static inline int KFN(boundary)(const KT *data, int size, KT value, int desc, int after) {
+    int lo = 0, hi = size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        KT v = data[mid];
+        int before = desc ? (after ? v >= value : v > value)
+                          : (after ? v <= value : v < value);
+        if (before)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static inline int KFN(findValues)(const KT *data, int size, unsigned order, KT value,
+                                  int *positions, int maxPositions) {
+    int count = 0;
+    if (order != 0) {
+        int desc = !(order & ORDER_ASCENDING);
+        int first = KFN(boundary)(data, size, value, desc, 0);
+        count = KFN(boundary)(data, size, value, desc, 1) - first;
+        for (int k = 0; k < count && k < maxPositions; k++)
+            positions[k] = first + k;
+        return count;
+    }
+    for (int i = 0; i < size; i++) {
+        if (data[i] == value) {
+            if (count < maxPositions)
+                positions[count] = i;
+            count++;
+        }
+    }
+    return count;
+}
+
+static inline int KFN(parseToken)(const char *tok, KT *out, const char **reason) {
+    char *end;
+    errno = 0;
+#if KFLOAT
+    KT v = KSTRTO(tok, &end);
+    if (end == tok || *end != '\0' || v != v) {
+        *reason = "is not a number";
+        return -1;
+    }
+    if (errno == ERANGE && (v > 1 || v < -1)) {
+        *reason = "is out of range";
+        return -1;
+    }
+    *out = v;
+#else
+    long long v = strtoll(tok, &end, 10);
+    if (end == tok || *end != '\0') {
+        *reason = "is not an integer";
+        return -1;
+    }
+    if (errno == ERANGE || v < KMIN || v > KMAX) {
+        *reason = "is out of range";
+        return -1;
+    }
+    *out = (KT)v;
+#endif
+    return 0;
+}
+
+static inline void KFN(formatValue)(KT v, char *buf, size_t n) {
+#if KFLOAT
+    /* Fewest digits (from 6 up) that read back as the same value */
+    for (int digits = 6; digits < KDIGITS; digits++) {
+        snprintf(buf, n, "%.*g", digits, (double)v);
+        if (KSTRTO(buf, NULL) == v)
+            return;
+    }
+    snprintf(buf, n, "%.*g", KDIGITS, (double)v);
+#else
+    snprintf(buf, n, KFMT, v);
+#endif
+}
+
+static inline int KFN(writeValues)(FILE *fp, const KT *data, int size, const char *sep) {
+    char buf[TYPED_TEXT_MAX];
+    for (int i = 0; i < size; i++) {
+        KFN(formatValue)(data[i], buf, sizeof(buf));
+        fputs(buf, fp);
+        fputs(sep, fp);
+    }
+    return ferror(fp) ? -1 : 0;
+}
+
+/* Append fp's values to ds a batch at a time; tokens that don't parse are
+   reported (the first few) and counted in *errors */
+static inline int KFN(loadValues)(FILE *fp, Dataset *ds, long long *errors, int *shown) {
+    KT batch[1024];
+    int n = 0, rc = INTPARSE_OK;
+    long long line = 0;
+    char *text = NULL;
+    size_t cap = 0;
+
+    while (rc == INTPARSE_OK && getline(&text, &cap, fp) != -1) {
+        line++;
+        char *save;
+        for (char *tok = strtok_r(text, " \t\r\n\v\f", &save); tok;
+             tok = strtok_r(NULL, " \t\r\n\v\f", &save)) {
+            const char *reason;
+            if (KFN(parseToken)(tok, &batch[n], &reason) != 0) {
+                if ((*shown)++ < INTPARSE_MAX_ERRORS_SHOWN)
+                    printf("Line %lld: '%.24s%s' %s; skipped.\n",
+                           line, tok, (strlen(tok) > 24) ? "..." : "", reason);
+                (*errors)++;
+                continue;
+            }
+            if (++n == (int)(sizeof(batch) / sizeof(batch[0]))) {
+                if (datasetAppendValues(ds, batch, n) != 0)
+                    rc = INTPARSE_NO_MEMORY;
+                n = 0;
+            }
+        }
+    }
+    if (rc == INTPARSE_OK && datasetAppendValues(ds, batch, n) != 0)
+        rc = INTPARSE_NO_MEMORY;
+    free(text);
+    return rc;
+}
+
+#undef KRADIX_PASSES
+#undef KRADIX_BUCKETS
+#undef KRADIX_BITS
+#undef KFN
+#undef KCAT
+#undef KCAT_
+#undef KT
+#undef KS
+#undef KKEY
+#undef KVAL
+#undef KFLOAT
+#undef KDIGITS
+#undef KMIN
+#undef KMAX
+#undef KFMT
+#undef KSTRTO
@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "alloc.h"
+
+/* ===================== Public API ===================== */
+
+void *allocOrDie(size_t bytes) {
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void *reallocOrDie(void *ptr, size_t bytes) {
+    void *p = realloc(ptr, bytes ? bytes : 1);
+    if (!p) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
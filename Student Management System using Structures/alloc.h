@@ -0,0 +1,14 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stddef.h>
+
+/*
+ * Allocation helpers for the in-memory indexes and scratch buffers:
+ * on failure they print the usual error and exit, so callers need no
+ * NULL checks. A zero-byte request still returns a valid pointer.
+ */
+void *allocOrDie(size_t bytes);
+void *reallocOrDie(void *ptr, size_t bytes);
+
+#endif /* ALLOC_H */
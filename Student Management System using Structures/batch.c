@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "student.h"
+#include "bulkload.h"
+
+#define MAX_COMMAND_LINE 1024
+
+/* ===================== Internal Helpers ===================== */
+
+/* Parse, validate and insert a CSV file; returns number added or -1 */
+static int importCsvFile(const char *csvFile) {
+    BulkResult r;
+    if (bulkParseFile(csvFile, bulkParseCsvLine, 0, &r) != 0)
+        return -1;
+
+    int added = storeAddStudents(r.records, r.count);
+    printf("Imported '%s': %d added, %d duplicate ID(s) skipped, %d invalid line(s).\n",
+           csvFile, added, r.count - added, r.errors);
+    bulkResultFree(&r);
+    return added;
+}
+
+/* count|range gpa|age <lo> <hi>: print the count, or every match in order */
+static int batchRange(int list, char *args, long lineNo) {
+    char *field = strtok(args, " \t");
+    float lo, hi;
+    RangeField f;
+    if (field && strcmp(field, "gpa") == 0) {
+        f = RANGE_BY_GPA;
+    } else if (field && strcmp(field, "age") == 0) {
+        f = RANGE_BY_AGE;
+    } else {
+        printf("Line %ld: expected 'gpa' or 'age'\n", lineNo);
+        return -1;
+    }
+    if (bulkParseFloatToken(strtok(NULL, " \t"), &lo) != 0 ||
+        bulkParseFloatToken(strtok(NULL, " \t"), &hi) != 0) {
+        printf("Line %ld: expected <lo> <hi>\n", lineNo);
+        return -1;
+    }
+
+    int total = storeCountRange(f, lo, hi);
+    printf("%s %.2f..%.2f: %d student(s)\n", field, lo, hi, total);
+    if (!list || total == 0)
+        return 0;
+
+    Student *rows = malloc((size_t)total * sizeof(Student));
+    if (!rows) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    /* The count can only shrink between the two calls in batch mode */
+    int n = storeRangeQuery(f, lo, hi, rows, total);
+    if (n > total) n = total;
+    for (int i = 0; i < n; i++) {
+        printf("%d %s %d %s %.2f\n", rows[i].id, rows[i].name, rows[i].age,
+               rows[i].course, rows[i].gpa);
+    }
+    free(rows);
+    return 0;
+}
+
+/* add <id> <name> <age> <course> <grade> [grade ...] */
+static int batchAdd(char *args, long lineNo) {
+    Student s;
+    const char *err;
+    if (bulkParseFields(args, &s, &err) != 1) {
+        printf("Line %ld: add: %s\n", lineNo, err);
+        return -1;
+    }
+    if (storeAddStudents(&s, 1) != 1) {
+        printf("Line %ld: add: student ID %d already exists\n", lineNo, s.id);
+        return -1;
+    }
+    return 0;
+}
+
+/* ===================== Public API ===================== */
+
+int runImport(const char *csvFile) {
+    if (importCsvFile(csvFile) < 0)
+        return -1;
+    saveSnapshot(SNAPSHOT_FILE);  /* persist once for the whole import */
+    return 0;
+}
+
+/*
+ * Command file, one command per line ('#' starts a comment):
+ *   import <file.csv>
+ *   add <id> <name> <age> <course> <grade> [grade ...]
+ *   delete <id>
+ *   export <file.txt>
+ *   compact
+ *   count gpa|age <lo> <hi>
+ *   range gpa|age <lo> <hi>
+ * All changes are persisted once, after the last command.
+ */
+int runBatch(const char *commandFile) {
+    FILE *fp = fopen(commandFile, "r");
+    if (!fp) {
+        printf("Error: could not open '%s'.\n", commandFile);
+        return -1;
+    }
+
+    char line[MAX_COMMAND_LINE];
+    long lineNo = 0;
+    int failures = 0, changed = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        line[strcspn(line, "\r\n")] = '\0';
+
+        char *cmd = strtok(line, " \t");
+        if (!cmd || cmd[0] == '#')
+            continue;
+        char *rest = strtok(NULL, "");  /* remainder of the line, or NULL */
+
+        if (strcmp(cmd, "add") == 0 && rest) {
+            if (batchAdd(rest, lineNo) != 0) failures++;
+            else changed = 1;
+            continue;
+        }
+        if ((strcmp(cmd, "count") == 0 || strcmp(cmd, "range") == 0) && rest) {
+            if (batchRange(strcmp(cmd, "range") == 0, rest, lineNo) != 0) failures++;
+            continue;
+        }
+
+        char *arg = rest ? strtok(rest, " \t") : NULL;
+        int id;
+        if (strcmp(cmd, "import") == 0 && arg) {
+            int added = importCsvFile(arg);
+            if (added < 0) failures++;
+            else changed |= added > 0;
+        } else if (strcmp(cmd, "delete") == 0 && bulkParseIntToken(arg, &id) == 0) {
+            if (storeDeleteStudent(id) != 0) {
+                printf("Line %ld: delete: student %d not found\n", lineNo, id);
+                failures++;
+            } else {
+                changed = 1;
+            }
+        } else if (strcmp(cmd, "export") == 0 && arg) {
+            saveToFile(arg);
+        } else if (strcmp(cmd, "compact") == 0) {
+            printf("Compacted: %d slot(s) reclaimed.\n", storeCompact());
+        } else {
+            printf("Line %ld: unknown or incomplete command '%s'\n", lineNo, cmd);
+            failures++;
+        }
+    }
+    fclose(fp);
+
+    if (changed)
+        saveSnapshot(SNAPSHOT_FILE);
+    printf("Batch finished: %ld line(s), %d failure(s).\n", lineNo, failures);
+    return failures == 0 ? 0 : -1;
+}
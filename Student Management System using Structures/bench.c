@@ -0,0 +1,531 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "alloc.h"
+#include "student.h"
+#include "gpastats.h"
+#include "journal.h"
+
+/*
+ * Benchmark for the student store (a separate program, see README):
+ *  - generates N synthetic students into students.txt in a scratch
+ *    directory, so the run never touches a real roster
+ *  - times the hot paths through the public API: text and snapshot
+ *    load/save, durable add/update/delete, ID and name lookups, range
+ *    queries, each sort and each report
+ *  - prints one JSON document with, per operation, the op count, total
+ *    time, throughput and latency percentiles in microseconds; items_per_s
+ *    counts the records each op scanned, sorted or returned
+ * Progress and the store's own messages go to stderr; stdout carries only
+ * the JSON (or use -o FILE).
+ */
+
+#define BENCH_MAX_PHASES 32
+#define BENCH_EXPORT_FILE "export.txt"
+#define BENCH_LIST_MAX    50  /* result rows copied out per search */
+#define BENCH_TOP_N       10
+
+typedef struct {
+    int      students;
+    int      queries;   /* ops per lookup/search phase */
+    int      writes;    /* ops per add/update/delete phase (each is fsync'd) */
+    int      repeat;    /* runs of each sort and each report */
+    uint64_t seed;
+} BenchConfig;
+
+/* One timed operation: every call is one latency sample */
+typedef struct {
+    const char *name;
+    int         ops;
+    long long   items;    /* records scanned, sorted or returned, for items_per_s */
+    double      totalUs;
+    float      *latency;  /* microseconds, one per op */
+} Phase;
+
+static Phase phases[BENCH_MAX_PHASES];
+static int   phaseCount = 0;
+
+static uint64_t rngState;
+
+/* ===================== Internal Helpers ===================== */
+
+/* xorshift64*: fast, and the same seed always gives the same roster */
+static uint64_t nextRandom(void) {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1DULL;
+}
+
+static int minInt(int a, int b) {
+    return (a < b) ? a : b;
+}
+
+/* Uniform in [0, n) */
+static int randomBelow(int n) {
+    return (int)(nextRandom() % (uint64_t)n);
+}
+
+static double nowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static Phase *phaseBegin(const char *name, int ops) {
+    if (phaseCount == BENCH_MAX_PHASES) {
+        fprintf(stderr, "Error: too many benchmark phases.\n");
+        exit(EXIT_FAILURE);
+    }
+    Phase *p   = &phases[phaseCount++];
+    p->name    = name;
+    p->ops     = 0;
+    p->items   = 0;
+    p->totalUs = 0;
+    p->latency = allocOrDie((ops > 0 ? ops : 1) * sizeof(float));
+    fprintf(stderr, "bench: %s x%d\n", name, ops);
+    return p;
+}
+
+/* Close one op started at startUs that processed `items` records */
+static void phaseLap(Phase *p, double startUs, long long items) {
+    double us = nowUs() - startUs;
+    p->latency[p->ops++] = (float)us;
+    p->totalUs += us;
+    p->items   += items;
+}
+
+/* Synthetic names and courses: a fixed vocabulary mixed by a hash of the ID */
+
+static const char *firstNames[] = {
+    "Ada", "Alan", "Amara", "Ben", "Chidi", "Clara", "Dara", "David", "Efua", "Elena",
+    "Femi", "Grace", "Hana", "Ivan", "Jomo", "Kofi", "Lena", "Maya", "Nia", "Omar",
+    "Priya", "Rosa", "Sami", "Tariq", "Uma", "Victor", "Wanjiru", "Yusuf", "Zara", "Kwame",
+    "Lucia", "Mateo"
+};
+static const char *lastNames[] = {
+    "Abebe", "Banda", "Chen", "Diallo", "Eze", "Fischer", "Garcia", "Hassan", "Ibrahim",
+    "Johnson", "Kamau", "Lopez", "Mensah", "Nakamura", "Okafor", "Petrov", "Quispe",
+    "Rossi", "Silva", "Tanaka", "Uwimana", "Vargas", "Wang", "Xu", "Yilmaz", "Zulu",
+    "Achebe", "Boateng", "Cohen", "Dubois", "Mwangi", "Novak"
+};
+static const char *subjects[] = {
+    "Computer_Science", "Mathematics", "Physics", "Chemistry", "Biology", "Economics",
+    "History", "Philosophy", "Literature", "Psychology", "Statistics", "Engineering",
+    "Medicine", "Law", "Architecture", "Music", "Linguistics", "Geography",
+    "Sociology", "Accounting"
+};
+
+#define FIRST_COUNT   (int)(sizeof(firstNames) / sizeof(firstNames[0]))
+#define LAST_COUNT    (int)(sizeof(lastNames) / sizeof(lastNames[0]))
+#define SUBJECT_COUNT (int)(sizeof(subjects) / sizeof(subjects[0]))
+#define COURSE_COUNT  (SUBJECT_COUNT * 2)  /* each subject at levels 101 and 201 */
+
+static uint32_t mixId(int id) {
+    uint32_t h = (uint32_t)id * 0x9E3779B1U;
+    return h ^ (h >> 15);
+}
+
+static void nameFor(int id, char *out) {
+    uint32_t h = mixId(id);
+    snprintf(out, MAX_NAME, "%s_%s", firstNames[h % FIRST_COUNT],
+             lastNames[(h / FIRST_COUNT) % LAST_COUNT]);
+}
+
+static void courseName(int course, char *out) {
+    snprintf(out, MAX_COURSE, "%s_%d01", subjects[course % SUBJECT_COUNT],
+             1 + course / SUBJECT_COUNT);
+}
+
+/* Random student with the given ID (name fixed by the ID, the rest drawn) */
+static void makeStudent(int id, Student *s) {
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+    nameFor(id, s->name);
+    s->age = 17 + randomBelow(20);
+    courseName(randomBelow(COURSE_COUNT), s->course);
+    s->numGrades = 3 + randomBelow(MAX_SUBJECTS - 2);
+    for (int j = 0; j < s->numGrades; j++) {
+        s->grades[j] = 35.0f + randomBelow(6501) / 100.0f;  /* 35.00 - 100.00 */
+    }
+}
+
+/* Write students 1..n to DATA_FILE in its text format */
+static int generateRoster(int n) {
+    FILE *fp = fopen(DATA_FILE, "w");
+    if (!fp) {
+        perror(DATA_FILE);
+        return -1;
+    }
+    fprintf(fp, "%d\n", n);
+    Student s;
+    for (int id = 1; id <= n; id++) {
+        makeStudent(id, &s);
+        fprintf(fp, "%d %s %d %s %d", s.id, s.name, s.age, s.course, s.numGrades);
+        for (int j = 0; j < s.numGrades; j++) {
+            fprintf(fp, " %.2f", s.grades[j]);
+        }
+        fprintf(fp, "\n");
+    }
+    if (fclose(fp) != 0) {
+        perror(DATA_FILE);
+        return -1;
+    }
+    return 0;
+}
+
+/* ===================== Benchmark Phases ===================== */
+
+static void benchLoadSave(const BenchConfig *cfg) {
+    Phase *p = phaseBegin("load_text", 1);
+    double t = nowUs();
+    initSystem();
+    phaseLap(p, t, cfg->students);
+
+    p = phaseBegin("save_text", 1);
+    t = nowUs();
+    saveToFile(BENCH_EXPORT_FILE);
+    phaseLap(p, t, cfg->students);
+
+    p = phaseBegin("save_snapshot", 1);
+    t = nowUs();
+    saveSnapshot(SNAPSHOT_FILE);
+    phaseLap(p, t, cfg->students);
+
+    /* A restart now maps the snapshot instead of parsing the text file */
+    cleanupSystem();
+    p = phaseBegin("load_snapshot", 1);
+    t = nowUs();
+    initSystem();
+    phaseLap(p, t, cfg->students);
+}
+
+static void benchLookups(const BenchConfig *cfg) {
+    Student *out = allocOrDie(BENCH_LIST_MAX * sizeof(Student));
+    char name[MAX_NAME];
+
+    Phase *p = phaseBegin("lookup_id", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        int id = 1 + randomBelow(cfg->students);
+        double t = nowUs();
+        storeGetStudent(id, out);
+        phaseLap(p, t, 1);
+    }
+
+    p = phaseBegin("lookup_name_exact", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        nameFor(1 + randomBelow(cfg->students), name);
+        double t = nowUs();
+        int total = storeFindByName(NAME_EXACT, name, 0, out, NULL, BENCH_LIST_MAX);
+        phaseLap(p, t, minInt(total, BENCH_LIST_MAX));
+    }
+
+    p = phaseBegin("lookup_name_prefix", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        nameFor(1 + randomBelow(cfg->students), name);
+        name[3] = '\0';
+        double t = nowUs();
+        int total = storeFindByName(NAME_PREFIX, name, 0, out, NULL, BENCH_LIST_MAX);
+        phaseLap(p, t, minInt(total, BENCH_LIST_MAX));
+    }
+
+    /* One letter of a real name replaced: what a typo in the search box looks like */
+    int dist[BENCH_LIST_MAX];
+    p = phaseBegin("lookup_name_fuzzy", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        nameFor(1 + randomBelow(cfg->students), name);
+        name[randomBelow((int)strlen(name))] = (char)('a' + randomBelow(26));
+        double t = nowUs();
+        int total = storeFindByName(NAME_FUZZY, name, 1, out, dist, BENCH_LIST_MAX);
+        phaseLap(p, t, minInt(total, BENCH_LIST_MAX));
+    }
+
+    p = phaseBegin("range_count_gpa", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        float lo = 35.0f + randomBelow(6000) / 100.0f;
+        double t = nowUs();
+        storeCountRange(RANGE_BY_GPA, lo, lo + 5.0f);
+        phaseLap(p, t, 1);
+    }
+
+    p = phaseBegin("range_query_age", cfg->queries);
+    for (int i = 0; i < cfg->queries; i++) {
+        float lo = (float)(17 + randomBelow(20));
+        double t = nowUs();
+        int total = storeRangeQuery(RANGE_BY_AGE, lo, lo, out, BENCH_LIST_MAX);
+        phaseLap(p, t, minInt(total, BENCH_LIST_MAX));
+    }
+    free(out);
+
+    /* Bounds at the ends of int must still cover every student */
+    if (storeCountRange(RANGE_BY_AGE, 0.0f, (float)INT_MAX) != cfg->students ||
+        storeCountRange(RANGE_BY_AGE, (float)INT_MIN, 2147483647.0f) != cfg->students) {
+        fprintf(stderr, "Error: full-range age count does not match the roster.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Durable single-record changes on IDs past the generated roster, which
+   the delete phase removes again so later phases see the original size */
+static void benchWrites(const BenchConfig *cfg) {
+    Student s;
+    int firstId = cfg->students + 1;
+
+    Phase *p = phaseBegin("add", cfg->writes);
+    for (int i = 0; i < cfg->writes; i++) {
+        makeStudent(firstId + i, &s);
+        double t = nowUs();
+        if (storeInsertStudent(&s) != STORE_OK) {
+            fprintf(stderr, "Error: add of ID %d failed.\n", s.id);
+            exit(EXIT_FAILURE);
+        }
+        phaseLap(p, t, 1);
+    }
+
+    p = phaseBegin("update", cfg->writes);
+    for (int i = 0; i < cfg->writes; i++) {
+        makeStudent(firstId + randomBelow(cfg->writes), &s);
+        double t = nowUs();
+        storeUpdateStudent(&s);
+        phaseLap(p, t, 1);
+    }
+
+    p = phaseBegin("delete", cfg->writes);
+    for (int i = 0; i < cfg->writes; i++) {
+        double t = nowUs();
+        storeRemoveStudent(firstId + i);
+        phaseLap(p, t, 1);
+    }
+}
+
+static void benchSorts(const BenchConfig *cfg) {
+    static const struct {
+        const char *name;
+        SortField   field;
+    } sorts[] = {
+        { "sort_gpa",  SORT_BY_GPA_DESC },
+        { "sort_name", SORT_BY_NAME_ASC },
+        { "sort_id",   SORT_BY_ID_ASC   }
+    };
+    Phase *p[3];
+    for (int k = 0; k < 3; k++) {
+        p[k] = phaseBegin(sorts[k].name, cfg->repeat);
+    }
+    /* Interleaved, so every run starts from another field's order */
+    for (int r = 0; r < cfg->repeat; r++) {
+        for (int k = 0; k < 3; k++) {
+            double t = nowUs();
+            storeSort(sorts[k].field);
+            phaseLap(p[k], t, cfg->students);
+        }
+    }
+}
+
+static void benchReports(const BenchConfig *cfg) {
+    static const double percents[] = { 10.0, 50.0, 90.0, 99.0 };
+    char course[MAX_COURSE];
+    StoreStats st;
+    float pct[4];
+    int counts[HISTOGRAM_BINS];
+    CourseSummary cs;
+    CourseSummary *all = allocOrDie(COURSE_COUNT * sizeof(CourseSummary));
+    Student *top = allocOrDie(BENCH_TOP_N * sizeof(Student));
+
+    Phase *p = phaseBegin("report_class_stats", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        double t = nowUs();
+        storeStats(NULL, &st);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_course_stats", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        courseName(randomBelow(COURSE_COUNT), course);
+        double t = nowUs();
+        storeStats(course, &st);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_percentiles", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        double t = nowUs();
+        storeGpaPercentiles(NULL, percents, 4, pct);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_histogram", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        double t = nowUs();
+        storeGpaHistogram(counts);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_top_n", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        double t = nowUs();
+        storeTopStudents(NULL, BENCH_TOP_N, top);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_top_n_in_course", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        courseName(randomBelow(COURSE_COUNT), course);
+        double t = nowUs();
+        storeTopStudents(course, BENCH_TOP_N, top);
+        phaseLap(p, t, cfg->students);
+    }
+
+    p = phaseBegin("report_course_summary", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        courseName(randomBelow(COURSE_COUNT), course);
+        double t = nowUs();
+        storeCourseSummary(course, &cs);
+        phaseLap(p, t, 1);
+    }
+
+    p = phaseBegin("report_all_courses", cfg->repeat);
+    for (int r = 0; r < cfg->repeat; r++) {
+        double t = nowUs();
+        int courses = storeAllCourses(all, COURSE_COUNT);
+        phaseLap(p, t, minInt(courses, COURSE_COUNT));
+    }
+    free(all);
+    free(top);
+}
+
+static void writeJson(FILE *out, const BenchConfig *cfg) {
+    static const double percents[] = { 0.0, 50.0, 90.0, 99.0, 100.0 };
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"student_store\",\n");
+    fprintf(out, "  \"students\": %d,\n", cfg->students);
+    fprintf(out, "  \"queries\": %d,\n", cfg->queries);
+    fprintf(out, "  \"writes\": %d,\n", cfg->writes);
+    fprintf(out, "  \"repeat\": %d,\n", cfg->repeat);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)cfg->seed);
+    fprintf(out, "  \"results\": [\n");
+    for (int i = 0; i < phaseCount; i++) {
+        Phase *p = &phases[i];
+        float lat[5] = { 0 };
+        if (p->ops > 0)
+            statsPercentiles(p->latency, p->ops, percents, 5, lat);
+        double seconds = p->totalUs / 1e6;
+        fprintf(out, "    {\"name\": \"%s\", \"ops\": %d, \"total_s\": %.6f, "
+                     "\"ops_per_s\": %.1f, \"items_per_s\": %.1f, "
+                     "\"latency_us\": {\"min\": %.2f, \"p50\": %.2f, \"p90\": %.2f, "
+                     "\"p99\": %.2f, \"max\": %.2f}}%s\n",
+                p->name, p->ops, seconds,
+                (seconds > 0) ? p->ops / seconds : 0.0,
+                (seconds > 0) ? p->items / seconds : 0.0,
+                lat[0], lat[1], lat[2], lat[3], lat[4],
+                (i + 1 < phaseCount) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-n STUDENTS] [-q QUERIES] [-w WRITES] [-r REPEAT]\n", prog);
+    fprintf(stderr, "          [-s SEED] [-d DIR] [-o FILE.json]\n");
+    fprintf(stderr, "  -n  synthetic students to generate (default 100000)\n");
+    fprintf(stderr, "  -q  operations per lookup/search benchmark (default 10000)\n");
+    fprintf(stderr, "  -w  durable adds, updates and deletes, each fsync'd (default 1000)\n");
+    fprintf(stderr, "  -r  runs of each sort and report (default 10)\n");
+    fprintf(stderr, "  -d  empty scratch directory (default: a new one under /tmp)\n");
+    fprintf(stderr, "  -o  write the JSON results to FILE instead of stdout\n");
+}
+
+/* Positive int option value, or -1 */
+static int parseCount(const char *text) {
+    char *end;
+    long v = strtol(text, &end, 10);
+    return (*end == '\0' && v > 0 && v <= 1000000000L) ? (int)v : -1;
+}
+
+/* ===================== Main ===================== */
+
+int main(int argc, char *argv[]) {
+    BenchConfig cfg = { 100000, 10000, 1000, 10, 42 };
+    const char *dir = NULL;
+    const char *outFile = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        if (i + 1 >= argc || opt[0] != '-' || opt[1] == '\0' || opt[2] != '\0') {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *val = argv[++i];
+        int bad = 0;
+        switch (opt[1]) {
+            case 'n': bad = (cfg.students = parseCount(val)) < 0; break;
+            case 'q': bad = (cfg.queries  = parseCount(val)) < 0; break;
+            case 'w': bad = (cfg.writes   = parseCount(val)) < 0; break;
+            case 'r': bad = (cfg.repeat   = parseCount(val)) < 0; break;
+            case 's': cfg.seed = strtoull(val, NULL, 10); break;
+            case 'd': dir = val; break;
+            case 'o': outFile = val; break;
+            default:  bad = 1; break;
+        }
+        if (bad) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    rngState = cfg.seed ? cfg.seed : 1;
+
+    /* Results go to the original stdout; the store's messages join stderr */
+    FILE *out = outFile ? fopen(outFile, "w") : fdopen(dup(STDOUT_FILENO), "w");
+    if (!out) {
+        perror(outFile ? outFile : "stdout");
+        return 1;
+    }
+    fflush(stdout);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    char scratch[] = "/tmp/student-bench-XXXXXX";
+    int ownDir = (dir == NULL);
+    if (ownDir && (dir = mkdtemp(scratch)) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    if (chdir(dir) != 0) {
+        perror(dir);
+        return 1;
+    }
+    if (access(DATA_FILE, F_OK) == 0 || access(SNAPSHOT_FILE, F_OK) == 0 ||
+        access(JOURNAL_FILE, F_OK) == 0) {
+        fprintf(stderr, "Error: '%s' already holds a student store; use an empty directory.\n", dir);
+        return 1;
+    }
+
+    fprintf(stderr, "bench: generating %d students in %s\n", cfg.students, dir);
+    if (generateRoster(cfg.students) != 0)
+        return 1;
+
+    benchLoadSave(&cfg);
+    benchLookups(&cfg);
+    benchWrites(&cfg);
+    benchSorts(&cfg);
+    benchReports(&cfg);
+    cleanupSystem();
+
+    writeJson(out, &cfg);
+    fclose(out);
+
+    unlink(DATA_FILE);
+    unlink(SNAPSHOT_FILE);
+    unlink(JOURNAL_FILE);
+    unlink(BENCH_EXPORT_FILE);
+    if (ownDir && chdir("/") == 0)
+        rmdir(dir);
+    for (int i = 0; i < phaseCount; i++) {
+        free(phases[i].latency);
+    }
+    return 0;
+}
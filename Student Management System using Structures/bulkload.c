@@ -0,0 +1,473 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bulkload.h"
+
+#define BULK_MIN_CHUNK (1 << 20)  /* don't split below 1 MiB per thread */
+#define BULK_MAX_THREADS 64
+#define BULK_MAX_FIELD_TEXT 1024  /* joined command fields */
+
+typedef struct {
+    long        lineNo;
+    const char *message;
+} BulkError;
+
+typedef struct {
+    const char     *begin;
+    const char     *end;
+    BulkLineParser  parse;
+    Student        *records;
+    int             count;
+    int             capacity;
+    long            lines;      /* lines in this chunk */
+    int             atStart;    /* begins at the start of the data */
+    BulkError       shown[BULK_MAX_ERRORS_SHOWN];
+    int             errors;
+    int             failed;     /* out of memory */
+} BulkChunk;
+
+/* ===================== Internal Helpers ===================== */
+
+static int isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* Parse every line of one chunk; line numbers are chunk-relative here
+   (bulkParse adds the lines of the chunks before it), so only a chunk
+   that begins the data can hand the parser its first line */
+static void *parseChunk(void *arg) {
+    BulkChunk *c = arg;
+    if (c->capacity > 0) {
+        /* Pre-sized from the expected count; allocated here so the pages
+           are first touched by the thread that fills them */
+        c->records = malloc((size_t)c->capacity * sizeof(Student));
+        if (!c->records) {
+            c->failed = 1;
+            return NULL;
+        }
+    }
+    const char *p = c->begin;
+    while (p < c->end) {
+        const char *nl = memchr(p, '\n', (size_t)(c->end - p));
+        const char *lineEnd = nl ? nl : c->end;
+        c->lines++;
+
+        Student s;
+        const char *err = NULL;
+        int rc = c->parse(p, lineEnd, c->atStart && c->lines == 1, &s, &err);
+        if (rc > 0) {
+            if (c->count >= c->capacity) {
+                int newCap = (c->capacity == 0) ? 1024 : c->capacity * 2;
+                Student *tmp = realloc(c->records, (size_t)newCap * sizeof(Student));
+                if (!tmp) {
+                    c->failed = 1;
+                    return NULL;
+                }
+                c->records  = tmp;
+                c->capacity = newCap;
+            }
+            c->records[c->count++] = s;
+        } else if (rc < 0) {
+            if (c->errors < BULK_MAX_ERRORS_SHOWN) {
+                c->shown[c->errors].lineNo  = c->lines;
+                c->shown[c->errors].message = err;
+            }
+            c->errors++;
+        }
+        p = lineEnd + 1;
+    }
+    return NULL;
+}
+
+static int onlineCpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > BULK_MAX_THREADS) n = BULK_MAX_THREADS;
+    return (int)n;
+}
+
+/* Record count announced by a first line holding a single integer, or 0 */
+static int headerCount(const char *data, size_t len) {
+    const char *p = data, *end = memchr(data, '\n', len);
+    if (!end)
+        end = data + len;
+    int n;
+    while (p < end && isBlank(*p)) p++;
+    if (bulkParseInt(&p, end, &n) != 0 || n < 0)
+        return 0;
+    while (p < end && isBlank(*p)) p++;
+    return (p == end) ? n : 0;
+}
+
+/* ===================== Public API ===================== */
+
+int bulkParse(const char *data, size_t len, BulkLineParser parse,
+              int threads, int expected, BulkResult *out) {
+    out->records = NULL;
+    out->count   = 0;
+    out->errors  = 0;
+    if (expected == BULK_HEADER_COUNT)
+        expected = headerCount(data, len);
+
+    if (threads <= 0)
+        threads = onlineCpus();
+    if ((size_t)threads > len / BULK_MIN_CHUNK)
+        threads = (int)(len / BULK_MIN_CHUNK);
+    if (threads < 1)
+        threads = 1;
+
+    BulkChunk chunks[BULK_MAX_THREADS];
+    pthread_t tids[BULK_MAX_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+
+    /* Split on line boundaries: each chunk ends just after a newline */
+    const char *start = data, *limit = data + len;
+    for (int t = 0; t < threads; t++) {
+        const char *end = (t == threads - 1) ? limit : data + len / threads * (t + 1);
+        if (end < start) end = start;
+        if (end < limit) {
+            const char *nl = memchr(end, '\n', (size_t)(limit - end));
+            end = nl ? nl + 1 : limit;
+        }
+        chunks[t].begin = start;
+        chunks[t].end   = end;
+        chunks[t].parse = parse;
+        chunks[t].atStart = (start == data);
+        if (expected > 0 && end > start) {
+            /* This chunk's share of the count plus some slack; a line takes
+               at least 8 bytes, which bounds a bogus header */
+            long long bytes = end - start;
+            long long share = (long long)expected * bytes / (long long)len;
+            share += share / 16 + 16;
+            if (share > bytes / 8 + 16)
+                share = bytes / 8 + 16;
+            chunks[t].capacity = (int)share;
+        }
+        start = end;
+    }
+
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, parseChunk, &chunks[t]) != 0)
+            break;
+        started = t;
+    }
+    parseChunk(&chunks[0]);
+    for (int t = 1; t <= started; t++)
+        pthread_join(tids[t], NULL);
+    for (int t = started + 1; t < threads; t++)
+        parseChunk(&chunks[t]);  /* thread creation failed: parse inline */
+
+    /* Concatenate in file order and report errors with global line numbers */
+    long total = 0, lineBase = 0;
+    int failed = 0;
+    for (int t = 0; t < threads; t++) {
+        total  += chunks[t].count;
+        failed |= chunks[t].failed;
+    }
+    if (!failed)
+        out->records = malloc((size_t)(total > 0 ? total : 1) * sizeof(Student));
+    if (!out->records)
+        failed = 1;
+
+    int shown = 0;
+    for (int t = 0; t < threads; t++) {
+        BulkChunk *c = &chunks[t];
+        if (!failed && c->count > 0) {
+            memcpy(out->records + out->count, c->records, (size_t)c->count * sizeof(Student));
+            out->count += c->count;
+        }
+        for (int e = 0; e < c->errors && e < BULK_MAX_ERRORS_SHOWN; e++) {
+            if (shown++ < BULK_MAX_ERRORS_SHOWN)
+                printf("Line %ld: %s\n", lineBase + c->shown[e].lineNo, c->shown[e].message);
+        }
+        out->errors += c->errors;
+        lineBase += c->lines;
+        free(c->records);
+    }
+
+    if (failed) {
+        printf("Error: memory allocation failed!\n");
+        bulkResultFree(out);
+        return -1;
+    }
+    return 0;
+}
+
+int bulkParseFile(const char *filename, BulkLineParser parse, int expected, BulkResult *out) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: could not open '%s'.\n", filename);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        printf("Error: could not read '%s'.\n", filename);
+        return -1;
+    }
+
+    size_t len = (size_t)st.st_size;
+    if (len == 0) {
+        close(fd);
+        return bulkParse("", 0, parse, 1, 0, out);
+    }
+    void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("Error: could not map '%s'.\n", filename);
+        return -1;
+    }
+    posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+
+    int rc = bulkParse(map, len, parse, 0, expected, out);
+    munmap(map, len);
+    return rc;
+}
+
+void bulkResultFree(BulkResult *r) {
+    free(r->records);
+    r->records = NULL;
+    r->count   = 0;
+}
+
+int bulkParseInt(const char **p, const char *end, int *out) {
+    const char *s = *p;
+    int neg = 0;
+    if (s < end && (*s == '-' || *s == '+')) {
+        neg = (*s == '-');
+        s++;
+    }
+    if (s >= end || *s < '0' || *s > '9')
+        return -1;
+
+    long long v = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        v = v * 10 + (*s - '0');
+        if (v > 2147483648LL)
+            return -1;
+        s++;
+    }
+    if (neg) v = -v;
+    if (v > 2147483647LL)
+        return -1;
+    *out = (int)v;
+    *p = s;
+    return 0;
+}
+
+int bulkParseFloat(const char **p, const char *end, float *out) {
+    static const double scale[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    const char *s = *p;
+    int neg = 0;
+    if (s < end && (*s == '-' || *s == '+')) {
+        neg = (*s == '-');
+        s++;
+    }
+
+    long long whole = 0, frac = 0;
+    int digits = 0, fracDigits = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        if (whole >= 100000000000LL)
+            return -1;  /* too long to hold exactly; no field needs it */
+        whole = whole * 10 + (*s - '0');
+        s++;
+        digits++;
+    }
+    if (s < end && *s == '.') {
+        s++;
+        while (s < end && *s >= '0' && *s <= '9') {
+            if (fracDigits < 9) {
+                frac = frac * 10 + (*s - '0');
+                fracDigits++;
+            }
+            s++;
+            digits++;
+        }
+    }
+    if (digits == 0)
+        return -1;
+
+    double v = (double)whole + (double)frac / scale[fracDigits];
+    *out = (float)(neg ? -v : v);
+    *p = s;
+    return 0;
+}
+
+int bulkParseIntToken(const char *tok, int *out) {
+    if (!tok)
+        return -1;
+    const char *p = tok, *end = tok + strlen(tok);
+    return (bulkParseInt(&p, end, out) == 0 && p == end) ? 0 : -1;
+}
+
+int bulkParseFloatToken(const char *tok, float *out) {
+    if (!tok)
+        return -1;
+    const char *p = tok, *end = tok + strlen(tok);
+    return (bulkParseFloat(&p, end, out) == 0 && p == end) ? 0 : -1;
+}
+
+/* Copy a single-word text field (up to a blank, or a comma if
+   stopAtComma) into dst */
+static int parseWordField(const char **p, const char *end, char *dst, size_t cap,
+                          int stopAtComma) {
+    const char *s = *p;
+    size_t n = 0;
+    while (s < end && !(stopAtComma && *s == ',') && !isBlank(*s)) {
+        if (n + 1 >= cap)
+            return -1;
+        dst[n++] = *s++;
+    }
+    if (n == 0)
+        return -1;
+    dst[n] = '\0';
+    *p = s;
+    return 0;
+}
+
+/* Expect at least one blank */
+static int skipBlanks(const char **p, const char *end) {
+    const char *s = *p;
+    if (s >= end || !isBlank(*s))
+        return -1;
+    while (s < end && isBlank(*s)) s++;
+    *p = s;
+    return 0;
+}
+
+/* Expect a comma (with optional surrounding blanks) */
+static int skipComma(const char **p, const char *end) {
+    const char *s = *p;
+    while (s < end && isBlank(*s)) s++;
+    if (s >= end || *s != ',')
+        return -1;
+    s++;
+    while (s < end && isBlank(*s)) s++;
+    *p = s;
+    return 0;
+}
+
+int bulkParseCsvLine(const char *line, const char *end, int firstLine,
+                     Student *out, const char **err) {
+    while (end > line && isBlank(end[-1])) end--;
+    const char *p = line;
+    while (p < end && isBlank(*p)) p++;
+    if (p == end || *p == '#')
+        return 0;
+
+    memset(out, 0, sizeof(*out));
+    if (bulkParseInt(&p, end, &out->id) != 0) {
+        if (firstLine)
+            return 0;  /* header row */
+        *err = "invalid student ID";
+        return -1;
+    }
+    if (skipComma(&p, end) != 0 || parseWordField(&p, end, out->name, MAX_NAME, 1) != 0) {
+        *err = "invalid name (1-49 characters, no spaces)";
+        return -1;
+    }
+    if (skipComma(&p, end) != 0 || bulkParseInt(&p, end, &out->age) != 0 || out->age <= 0) {
+        *err = "invalid age";
+        return -1;
+    }
+    if (skipComma(&p, end) != 0 || parseWordField(&p, end, out->course, MAX_COURSE, 1) != 0) {
+        *err = "invalid course (1-49 characters, no spaces)";
+        return -1;
+    }
+    while (p < end) {
+        float g;
+        if (out->numGrades == MAX_SUBJECTS) {
+            *err = "too many grades";
+            return -1;
+        }
+        if (skipComma(&p, end) != 0 || bulkParseFloat(&p, end, &g) != 0 ||
+            g < 0.0f || g > 100.0f) {
+            *err = "invalid grade (0-100)";
+            return -1;
+        }
+        out->grades[out->numGrades++] = g;
+        while (p < end && isBlank(*p)) p++;
+    }
+    if (out->numGrades == 0) {
+        *err = "at least one grade is required";
+        return -1;
+    }
+    return 1;
+}
+
+int bulkParseFields(const char *text, Student *out, const char **err) {
+    /* Join the blank-separated fields into a CSV row to reuse its validation */
+    char row[BULK_MAX_FIELD_TEXT];
+    size_t n = 0;
+    const char *p = text ? text : "";
+    while (*p) {
+        if (isBlank(*p)) {
+            p++;
+            continue;
+        }
+        if (n > 0)
+            row[n++] = ',';
+        while (*p && !isBlank(*p) && n < sizeof(row) - 1)
+            row[n++] = *p++;
+        if (n >= sizeof(row) - 1) {
+            *err = "line too long";
+            return -1;
+        }
+    }
+
+    *err = "missing fields";
+    return (bulkParseCsvLine(row, row + n, 0, out, err) == 1) ? 1 : -1;
+}
+
+int bulkParseTextLine(const char *line, const char *end, int firstLine,
+                      Student *out, const char **err) {
+    while (end > line && isBlank(end[-1])) end--;
+    const char *p = line;
+    while (p < end && isBlank(*p)) p++;
+    if (p == end)
+        return 0;
+
+    memset(out, 0, sizeof(*out));
+    if (bulkParseInt(&p, end, &out->id) != 0) {
+        *err = "invalid student ID";
+        return -1;
+    }
+    if (p == end && firstLine)
+        return 0;  /* leading student count */
+    if (skipBlanks(&p, end) != 0 || parseWordField(&p, end, out->name, MAX_NAME, 0) != 0) {
+        *err = "invalid name (1-49 characters, no spaces)";
+        return -1;
+    }
+    if (skipBlanks(&p, end) != 0 || bulkParseInt(&p, end, &out->age) != 0) {
+        *err = "invalid age";
+        return -1;
+    }
+    if (skipBlanks(&p, end) != 0 || parseWordField(&p, end, out->course, MAX_COURSE, 0) != 0) {
+        *err = "invalid course (1-49 characters, no spaces)";
+        return -1;
+    }
+    if (skipBlanks(&p, end) != 0 || bulkParseInt(&p, end, &out->numGrades) != 0) {
+        *err = "invalid number of grades";
+        return -1;
+    }
+
+    /* Lenient like the format's writer: the count is clamped and
+       missing grades read as zero */
+    if (out->numGrades < 0) out->numGrades = 0;
+    if (out->numGrades > MAX_SUBJECTS) out->numGrades = MAX_SUBJECTS;
+    for (int i = 0; i < out->numGrades && p < end; i++) {
+        if (skipBlanks(&p, end) != 0 || bulkParseFloat(&p, end, &out->grades[i]) != 0) {
+            *err = "invalid grade";
+            return -1;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,69 @@
+#ifndef BULKLOAD_H
+#define BULKLOAD_H
+
+#include <stddef.h>
+#include "student.h"
+
+/*
+ * Parallel bulk parser for line-oriented student files:
+ *  - the file is mmap'd and split into one chunk per core on line boundaries
+ *  - each thread parses its chunk into a private array (no shared state),
+ *    pre-sized from the expected record count when one is known
+ *  - chunks are concatenated in file order, so "first record wins" holds
+ *  - bad lines are reported with their line number and skipped
+ */
+#define BULK_MAX_ERRORS_SHOWN 10
+#define BULK_HEADER_COUNT     (-1)  /* expected count: read it from a leading count line */
+
+/*
+ * Parse one line [line, end) into *out. firstLine is nonzero only for the
+ * first line of the data, the one place a header may appear.
+ * Returns 1 for a record, 0 to skip the line (blank, comment, header),
+ * or -1 with *err set to a short message.
+ */
+typedef int (*BulkLineParser)(const char *line, const char *end,
+                              int firstLine, Student *out, const char **err);
+
+typedef struct {
+    Student *records;   /* malloc'd, in file order */
+    int      count;
+    int      errors;    /* lines rejected by the parser */
+} BulkResult;
+
+/*
+ * Parse data[0..len) on up to threads threads (0 = one per core).
+ * expected is the number of records the data should hold (0 if unknown,
+ * or BULK_HEADER_COUNT); it only sizes the buffers.
+ */
+int  bulkParse(const char *data, size_t len, BulkLineParser parse,
+               int threads, int expected, BulkResult *out);
+
+/* mmap filename and bulkParse it. Returns 0 on success, -1 if unreadable. */
+int  bulkParseFile(const char *filename, BulkLineParser parse, int expected, BulkResult *out);
+
+void bulkResultFree(BulkResult *r);
+
+/* CSV rows: id,name,age,course,grade1[,grade2...]; a leading header is skipped */
+int  bulkParseCsvLine(const char *line, const char *end, int firstLine,
+                      Student *out, const char **err);
+
+/* students.txt rows: id name age course numGrades grade...; the leading
+   count line is skipped */
+int  bulkParseTextLine(const char *line, const char *end, int firstLine,
+                       Student *out, const char **err);
+
+/* Blank-separated fields (id name age course grade...) as typed in batch
+   and server commands, validated like a CSV row. Returns 1 for a record,
+   -1 with *err set otherwise. */
+int  bulkParseFields(const char *text, Student *out, const char **err);
+
+/* Hand-written field parsers; advance *p past the number, 0 on success */
+int  bulkParseInt(const char **p, const char *end, int *out);
+int  bulkParseFloat(const char **p, const char *end, float *out);
+
+/* Whole NUL-terminated token (NULL allowed) as a number; trailing junk
+   is an error. 0 on success, -1 otherwise. */
+int  bulkParseIntToken(const char *tok, int *out);
+int  bulkParseFloatToken(const char *tok, float *out);
+
+#endif /* BULKLOAD_H */
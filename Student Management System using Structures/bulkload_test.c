@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bulkload.h"
+
+/*
+ * Checks for the parallel bulk parser (bulkload.c). Every data set is
+ * large enough to be split into several chunks, so chunk boundaries fall
+ * right before the lines under test.
+ */
+#define TEST_THREADS 4
+#define TEST_LINES   300000
+
+static int failures = 0;
+
+static void expect(int ok, const char *what) {
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok)
+        failures++;
+}
+
+/* header (or NULL), then TEST_LINES copies of row */
+static char *buildData(const char *header, const char *row, size_t *len) {
+    size_t rowLen = strlen(row), headLen = header ? strlen(header) : 0;
+    char *data = malloc(headLen + rowLen * TEST_LINES + 1);
+    if (!data) {
+        printf("Error: memory allocation failed!\n");
+        exit(1);
+    }
+    if (header)
+        memcpy(data, header, headLen);
+    for (long i = 0; i < TEST_LINES; i++)
+        memcpy(data + headLen + rowLen * (size_t)i, row, rowLen);
+    *len = headLen + rowLen * TEST_LINES;
+    data[*len] = '\0';
+    return data;
+}
+
+static void testCsvInvalidRows(void) {
+    /* Only the first line may be a header: an invalid row that starts a
+       later chunk is still an error */
+    size_t len;
+    char *data = buildData(NULL, "x,Bad_Row,20,CS,50\n", &len);
+    BulkResult r;
+    int rc = bulkParse(data, len, bulkParseCsvLine, TEST_THREADS, 0, &r);
+    expect(rc == 0 && r.count == 0 && r.errors == TEST_LINES - 1,
+           "csv: every invalid row after the header line is reported");
+    bulkResultFree(&r);
+    free(data);
+
+    data = buildData("id,name,age,course,grade\n", "x,Bad_Row,20,CS,50\n", &len);
+    rc = bulkParse(data, len, bulkParseCsvLine, TEST_THREADS, 0, &r);
+    expect(rc == 0 && r.count == 0 && r.errors == TEST_LINES,
+           "csv: a header is skipped, every invalid row reported");
+    bulkResultFree(&r);
+    free(data);
+}
+
+static void testCsvValidRows(void) {
+    size_t len;
+    char *data = buildData("id,name,age,course,grade\n", "7,Good_Row,20,CS,50,60\n", &len);
+    BulkResult r;
+    int rc = bulkParse(data, len, bulkParseCsvLine, TEST_THREADS, 0, &r);
+    expect(rc == 0 && r.count == TEST_LINES && r.errors == 0,
+           "csv: valid rows survive every chunk boundary");
+    if (rc == 0 && r.count > 0)
+        expect(r.records[r.count - 1].numGrades == 2, "csv: grades parsed");
+    bulkResultFree(&r);
+    free(data);
+}
+
+static void testCsvLongNumbers(void) {
+    /* A grade with more whole digits than the parser holds is rejected,
+       not truncated to some other in-range value */
+    size_t len;
+    char *data = buildData(NULL, "7,Long_Grade,20,CS,123456789012345\n", &len);
+    BulkResult r;
+    int rc = bulkParse(data, len, bulkParseCsvLine, TEST_THREADS, 0, &r);
+    expect(rc == 0 && r.count == 0 && r.errors == TEST_LINES,
+           "csv: an overlong grade is an error on every line");
+    bulkResultFree(&r);
+    free(data);
+
+    float v;
+    expect(bulkParseFloatToken("99999999999.5", &v) == 0 && v > 9.9e10f &&
+           bulkParseFloatToken("123456789012345", &v) != 0,
+           "token: whole parts of 12+ digits are rejected");
+}
+
+static void testTextCountLine(void) {
+    /* A lone integer is the student count only on the first line; one
+       that starts a later chunk is a malformed record */
+    size_t len;
+    char *data = buildData(NULL, "42\n", &len);
+    BulkResult r;
+    int rc = bulkParse(data, len, bulkParseTextLine, TEST_THREADS, 0, &r);
+    expect(rc == 0 && r.count == 0 && r.errors == TEST_LINES - 1,
+           "text: only the leading count line is skipped");
+    bulkResultFree(&r);
+    free(data);
+
+    data = buildData("300000\n", "7 Good_Row 20 CS 2 50 60\n", &len);
+    rc = bulkParse(data, len, bulkParseTextLine, TEST_THREADS, BULK_HEADER_COUNT, &r);
+    expect(rc == 0 && r.count == TEST_LINES && r.errors == 0,
+           "text: records after the count line all load");
+    bulkResultFree(&r);
+    free(data);
+}
+
+int main(void) {
+    testCsvInvalidRows();
+    testCsvValidRows();
+    testCsvLongNumbers();
+    testTextCountLine();
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
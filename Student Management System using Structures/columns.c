@@ -0,0 +1,150 @@
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "columns.h"
+#include "alloc.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* ===================== Internal Helpers ===================== */
+
+/* Course id range selected by a courseId argument */
+static void courseRange(int courseId, int *lo, int *hi) {
+    if (courseId == ALL_COURSES) {
+        *lo = 0;
+        *hi = INT_MAX;
+    } else {
+        *lo = courseId;
+        *hi = courseId;
+    }
+}
+
+/* ===================== Maintenance ===================== */
+
+void columnsInit(StudentColumns *c) {
+    c->gpa      = NULL;
+    c->courseId = NULL;
+    c->age      = NULL;
+    c->count    = 0;
+    c->capacity = 0;
+}
+
+void columnsFree(StudentColumns *c) {
+    free(c->gpa);
+    free(c->courseId);
+    free(c->age);
+    columnsInit(c);
+}
+
+void columnsResize(StudentColumns *c, int count) {
+    if (count > c->capacity) {
+        int newCap = (c->capacity == 0) ? 16 : c->capacity;
+        while (newCap < count) newCap *= 2;
+        c->gpa      = reallocOrDie(c->gpa, (size_t)newCap * sizeof(float));
+        c->courseId = reallocOrDie(c->courseId, (size_t)newCap * sizeof(int));
+        c->age      = reallocOrDie(c->age, (size_t)newCap * sizeof(int));
+        c->capacity = newCap;
+    }
+    c->count = count;
+}
+
+void columnsSetRow(StudentColumns *c, int row, float gpa, int courseId, int age) {
+    c->gpa[row]      = gpa;
+    c->courseId[row] = courseId;
+    c->age[row]      = age;
+}
+
+void columnsKillRow(StudentColumns *c, int row) {
+    c->courseId[row] = DEAD_ROW;
+}
+
+/* ===================== Aggregate Kernels ===================== */
+
+void columnsAggregate(const StudentColumns *c, int courseId, ColumnAggregate *out) {
+    int lo, hi;
+    courseRange(courseId, &lo, &hi);
+
+    int    n   = c->count;
+    int    i   = 0;
+    int    cnt = 0;
+    double gpaSum = 0.0, ageSum = 0.0;
+    float  mn = INFINITY, mx = -INFINITY;
+
+#if defined(__SSE2__)
+    const __m128i vlo  = _mm_set1_epi32(lo - 1);  /* lo >= 0, so no overflow */
+    const __m128i vhi  = _mm_set1_epi32(hi);
+    const __m128  pinf = _mm_set1_ps(INFINITY);
+    const __m128  ninf = _mm_set1_ps(-INFINITY);
+    __m128i vcnt = _mm_setzero_si128();
+    __m128d gs0 = _mm_setzero_pd(), gs1 = _mm_setzero_pd();
+    __m128d as0 = _mm_setzero_pd(), as1 = _mm_setzero_pd();
+    __m128  vmin = pinf, vmax = ninf;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i ids = _mm_loadu_si128((const __m128i *)(c->courseId + i));
+        /* selected lanes: lo <= id <= hi */
+        __m128i m  = _mm_andnot_si128(_mm_cmpgt_epi32(ids, vhi), _mm_cmpgt_epi32(ids, vlo));
+        __m128  mf = _mm_castsi128_ps(m);
+
+        __m128 g = _mm_and_ps(mf, _mm_loadu_ps(c->gpa + i));
+        __m128 a = _mm_and_ps(mf, _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(c->age + i))));
+
+        vcnt = _mm_sub_epi32(vcnt, m);  /* m is -1 in selected lanes */
+        gs0  = _mm_add_pd(gs0, _mm_cvtps_pd(g));
+        gs1  = _mm_add_pd(gs1, _mm_cvtps_pd(_mm_movehl_ps(g, g)));
+        as0  = _mm_add_pd(as0, _mm_cvtps_pd(a));
+        as1  = _mm_add_pd(as1, _mm_cvtps_pd(_mm_movehl_ps(a, a)));
+        vmin = _mm_min_ps(vmin, _mm_or_ps(g, _mm_andnot_ps(mf, pinf)));
+        vmax = _mm_max_ps(vmax, _mm_or_ps(g, _mm_andnot_ps(mf, ninf)));
+    }
+
+    int   lanesI[4];
+    float lanesMin[4], lanesMax[4];
+    double lanesD[2];
+    _mm_storeu_si128((__m128i *)lanesI, vcnt);
+    _mm_storeu_ps(lanesMin, vmin);
+    _mm_storeu_ps(lanesMax, vmax);
+    for (int k = 0; k < 4; k++) {
+        cnt += lanesI[k];
+        if (lanesMin[k] < mn) mn = lanesMin[k];
+        if (lanesMax[k] > mx) mx = lanesMax[k];
+    }
+    _mm_storeu_pd(lanesD, _mm_add_pd(gs0, gs1));
+    gpaSum = lanesD[0] + lanesD[1];
+    _mm_storeu_pd(lanesD, _mm_add_pd(as0, as1));
+    ageSum = lanesD[0] + lanesD[1];
+#endif
+
+    for (; i < n; i++) {
+        int id = c->courseId[i];
+        if (id < lo || id > hi)
+            continue;
+        float g = c->gpa[i];
+        cnt++;
+        gpaSum += g;
+        ageSum += c->age[i];
+        if (g < mn) mn = g;
+        if (g > mx) mx = g;
+    }
+
+    out->count  = cnt;
+    out->gpaSum = gpaSum;
+    out->ageSum = ageSum;
+    out->minGpa = cnt ? mn : 0.0f;
+    out->maxGpa = cnt ? mx : 0.0f;
+}
+
+int columnsCopyGpa(const StudentColumns *c, int courseId, float *out) {
+    int lo, hi;
+    courseRange(courseId, &lo, &hi);
+    int n = 0;
+    for (int i = 0; i < c->count; i++) {
+        int id = c->courseId[i];
+        if (id >= lo && id <= hi)
+            out[n++] = c->gpa[i];
+    }
+    return n;
+}
@@ -0,0 +1,42 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+/*
+ * Columnar (struct-of-arrays) mirror of the fields the reports read.
+ * Row i always describes students[i]; student.c keeps it in sync.
+ * Aggregates scan only the contiguous columns they need, 4 rows at a
+ * time with SSE2 where available (scalar fallback otherwise).
+ */
+#define ALL_COURSES (-1)
+#define DEAD_ROW    (-1)  /* courseId of a deleted (tombstoned) row; no filter selects it */
+
+typedef struct {
+    float *gpa;
+    int   *courseId;   /* id from the course string pool, or DEAD_ROW */
+    int   *age;
+    int    count;
+    int    capacity;
+} StudentColumns;
+
+/* Result of one fused pass over the selected rows */
+typedef struct {
+    int    count;
+    double gpaSum;
+    double ageSum;
+    float  minGpa;
+    float  maxGpa;
+} ColumnAggregate;
+
+void columnsInit(StudentColumns *c);
+void columnsFree(StudentColumns *c);
+void columnsResize(StudentColumns *c, int count);
+void columnsSetRow(StudentColumns *c, int row, float gpa, int courseId, int age);
+void columnsKillRow(StudentColumns *c, int row);    /* mark row as DEAD_ROW */
+
+/* Aggregate rows of one course, or of every live row with ALL_COURSES */
+void columnsAggregate(const StudentColumns *c, int courseId, ColumnAggregate *out);
+
+/* Copy the GPAs of the selected rows into out; returns how many were copied */
+int  columnsCopyGpa(const StudentColumns *c, int courseId, float *out);
+
+#endif /* COLUMNS_H */
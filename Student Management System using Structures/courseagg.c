@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "courseagg.h"
+#include "alloc.h"
+
+/* ===================== Internal Helpers ===================== */
+
+/* Heap order: higher GPA first, then lower ID */
+static int ranksHigher(const CourseHeapEntry *x, const CourseHeapEntry *y) {
+    return x->gpa > y->gpa || (x->gpa == y->gpa && x->id < y->id);
+}
+
+static void placeAt(CourseAggregates *a, CourseStats *c, int pos, CourseHeapEntry e) {
+    c->heap[pos] = e;
+    idIndexPut(&a->heapPos, e.id, pos);
+}
+
+static void siftUp(CourseAggregates *a, CourseStats *c, int pos) {
+    CourseHeapEntry e = c->heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!ranksHigher(&e, &c->heap[parent]))
+            break;
+        placeAt(a, c, pos, c->heap[parent]);
+        pos = parent;
+    }
+    placeAt(a, c, pos, e);
+}
+
+static void siftDown(CourseAggregates *a, CourseStats *c, int pos) {
+    CourseHeapEntry e = c->heap[pos];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= c->count)
+            break;
+        if (child + 1 < c->count && ranksHigher(&c->heap[child + 1], &c->heap[child]))
+            child++;
+        if (!ranksHigher(&c->heap[child], &e))
+            break;
+        placeAt(a, c, pos, c->heap[child]);
+        pos = child;
+    }
+    placeAt(a, c, pos, e);
+}
+
+static CourseStats *statsFor(CourseAggregates *a, int courseId) {
+    if (courseId >= a->count) {
+        int newCount = courseId + 1;
+        a->courses = reallocOrDie(a->courses, (size_t)newCount * sizeof(CourseStats));
+        memset(a->courses + a->count, 0, (size_t)(newCount - a->count) * sizeof(CourseStats));
+        a->count = newCount;
+    }
+    return &a->courses[courseId];
+}
+
+/* ===================== Public API ===================== */
+
+void courseAggInit(CourseAggregates *a) {
+    a->courses = NULL;
+    a->count   = 0;
+    idIndexInit(&a->heapPos);
+}
+
+void courseAggFree(CourseAggregates *a) {
+    for (int i = 0; i < a->count; i++) {
+        free(a->courses[i].heap);
+    }
+    free(a->courses);
+    idIndexFree(&a->heapPos);
+    courseAggInit(a);
+}
+
+void courseAggClear(CourseAggregates *a) {
+    for (int i = 0; i < a->count; i++) {
+        a->courses[i].gpaSum = 0.0;
+        a->courses[i].count  = 0;
+    }
+    idIndexClear(&a->heapPos);
+}
+
+void courseAggAdd(CourseAggregates *a, int courseId, int studentId, float gpa) {
+    CourseStats *c = statsFor(a, courseId);
+    if (c->count >= c->heapCap) {
+        c->heapCap = (c->heapCap == 0) ? 4 : c->heapCap * 2;
+        c->heap    = reallocOrDie(c->heap, (size_t)c->heapCap * sizeof(CourseHeapEntry));
+    }
+    c->gpaSum += gpa;
+    c->heap[c->count].gpa = gpa;
+    c->heap[c->count].id  = studentId;
+    c->count++;
+    siftUp(a, c, c->count - 1);
+}
+
+void courseAggRemove(CourseAggregates *a, int courseId, int studentId) {
+    int pos = idIndexGet(&a->heapPos, studentId);
+    if (courseId < 0 || courseId >= a->count || pos == -1)
+        return;
+
+    CourseStats *c = &a->courses[courseId];
+    c->gpaSum -= c->heap[pos].gpa;
+    idIndexRemove(&a->heapPos, studentId);
+    c->count--;
+    if (c->count == 0)
+        c->gpaSum = 0.0;  /* drop accumulated rounding error */
+    if (pos == c->count)
+        return;
+
+    /* Move the last entry into the hole and restore heap order */
+    placeAt(a, c, pos, c->heap[c->count]);
+    if (pos > 0 && ranksHigher(&c->heap[pos], &c->heap[(pos - 1) / 2]))
+        siftUp(a, c, pos);
+    else
+        siftDown(a, c, pos);
+}
+
+const CourseStats *courseAggGet(const CourseAggregates *a, int courseId) {
+    if (courseId < 0 || courseId >= a->count)
+        return NULL;
+    return &a->courses[courseId];
+}
+
+int courseAggTop(const CourseAggregates *a, int courseId, int *studentId) {
+    const CourseStats *c = courseAggGet(a, courseId);
+    if (!c || c->count == 0)
+        return 0;
+    *studentId = c->heap[0].id;
+    return 1;
+}
@@ -0,0 +1,44 @@
+#ifndef COURSEAGG_H
+#define COURSEAGG_H
+
+#include "idindex.h"
+
+/*
+ * Per-course aggregates maintained incrementally on every change:
+ *  - running GPA sum and student count (course average in O(1))
+ *  - an indexed max-heap of (gpa, id) per course (top student in O(1),
+ *    insert/remove/update in O(log n)); ties go to the lower ID
+ * Courses are identified by their string-pool id.
+ */
+typedef struct {
+    float gpa;
+    int   id;
+} CourseHeapEntry;
+
+typedef struct {
+    double           gpaSum;
+    int              count;
+    CourseHeapEntry *heap;
+    int              heapCap;
+} CourseStats;
+
+typedef struct {
+    CourseStats *courses;   /* indexed by course id */
+    int          count;
+    IdIndex      heapPos;   /* student id -> position in its course heap */
+} CourseAggregates;
+
+void courseAggInit(CourseAggregates *a);
+void courseAggFree(CourseAggregates *a);
+void courseAggClear(CourseAggregates *a);
+
+void courseAggAdd(CourseAggregates *a, int courseId, int studentId, float gpa);
+void courseAggRemove(CourseAggregates *a, int courseId, int studentId);
+
+/* Stats for a course (NULL if it never had students) */
+const CourseStats *courseAggGet(const CourseAggregates *a, int courseId);
+
+/* Store the top student's ID in *studentId; returns 0 if the course is empty */
+int  courseAggTop(const CourseAggregates *a, int courseId, int *studentId);
+
+#endif /* COURSEAGG_H */
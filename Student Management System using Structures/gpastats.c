@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include "gpastats.h"
+
+/* ===================== Internal Helpers ===================== */
+
+static void swapf(float *a, float *b) {
+    float t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static int compareFloats(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+/* Median of lo, mid and hi, moved to values[hi] as the pivot */
+static void choosePivot(float *v, int lo, int hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (v[mid] < v[lo]) swapf(&v[mid], &v[lo]);
+    if (v[hi] < v[lo])  swapf(&v[hi], &v[lo]);
+    if (v[mid] < v[hi]) swapf(&v[mid], &v[hi]);
+}
+
+/* Select within [lo, hi] so that values[k] holds the k-th smallest */
+static float selectRange(float *v, int lo, int hi, int k) {
+    int budget = 64;  /* partition rounds before falling back to a sort */
+    while (lo < hi) {
+        if (--budget == 0) {
+            qsort(v + lo, (size_t)(hi - lo + 1), sizeof(float), compareFloats);
+            break;
+        }
+        choosePivot(v, lo, hi);
+        float pivot = v[hi];
+
+        /* Three-way partition: [lo, lt) < pivot, [lt, gt] == pivot, (gt, hi] > pivot */
+        int lt = lo, i = lo, gt = hi;
+        while (i <= gt) {
+            if (v[i] < pivot)
+                swapf(&v[lt++], &v[i++]);
+            else if (v[i] > pivot)
+                swapf(&v[i], &v[gt--]);
+            else
+                i++;
+        }
+        if (k < lt)
+            hi = lt - 1;
+        else if (k > gt)
+            lo = gt + 1;
+        else
+            return v[k];
+    }
+    return v[k];
+}
+
+/* Smallest value in [lo, hi] */
+static float minRange(const float *v, int lo, int hi) {
+    float m = v[lo];
+    for (int i = lo + 1; i <= hi; i++)
+        if (v[i] < m) m = v[i];
+    return m;
+}
+
+/* ===================== Public API ===================== */
+
+float statsSelect(float *values, int n, int k) {
+    return selectRange(values, 0, n - 1, k);
+}
+
+void statsPercentiles(float *values, int n, const double *percents,
+                      int count, float *results) {
+    int from = 0;  /* everything left of from is already <= later ranks */
+    for (int i = 0; i < count; i++) {
+        double rank = percents[i] / 100.0 * (n - 1);
+        int    k    = (int)rank;
+        double frac = rank - k;
+
+        float low = selectRange(values, from, n - 1, k);
+        float value = low;
+        if (frac > 0.0 && k + 1 < n) {
+            /* values right of k are all >= low; the next rank is their minimum */
+            float high = minRange(values, k + 1, n - 1);
+            value = (float)(low + (high - low) * frac);
+        }
+        results[i] = value;
+        from = k;
+    }
+}
+
+void statsHistogram(const float *values, int n, int counts[HISTOGRAM_BINS]) {
+    for (int b = 0; b < HISTOGRAM_BINS; b++)
+        counts[b] = 0;
+    for (int i = 0; i < n; i++) {
+        int b = (int)(values[i] / (100.0f / HISTOGRAM_BINS));
+        if (b < 0) b = 0;
+        if (b >= HISTOGRAM_BINS) b = HISTOGRAM_BINS - 1;
+        counts[b]++;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef GPASTATS_H
+#define GPASTATS_H
+
+/*
+ * Order statistics over a scratch array of GPAs:
+ *  - statsSelect is an expected linear-time quickselect (median-of-three
+ *    pivots, falling back to a full sort if partitioning keeps degrading)
+ *  - percentiles interpolate linearly between neighbouring ranks, so the
+ *    50th percentile is the usual median (mean of the middle pair for even n)
+ *  - all functions may reorder the values they are given
+ */
+#define HISTOGRAM_BINS 10  /* 10-point buckets over the 0-100 grade scale */
+
+/* k-th smallest (0-based) of values[0..n), partially reordering them */
+float statsSelect(float *values, int n, int k);
+
+/*
+ * Compute several percentiles (each in [0, 100]) in one call.
+ * percents must be ascending; results[i] receives percents[i].
+ */
+void  statsPercentiles(float *values, int n, const double *percents,
+                       int count, float *results);
+
+/* Count values per HISTOGRAM_BINS bucket over [0, 100] (100 goes in the last) */
+void  statsHistogram(const float *values, int n, int counts[HISTOGRAM_BINS]);
+
+#endif /* GPASTATS_H */
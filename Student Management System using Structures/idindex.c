@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "idindex.h"
+
+/* ===================== Internal Helpers ===================== */
+
+/* Integer mixer so sequential IDs spread over the whole table */
+static unsigned int hashKey(int key) {
+    unsigned int h = (unsigned int)key;
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    h *= 0x846ca68bU;
+    h ^= h >> 16;
+    return h;
+}
+
+static IdIndexEntry *allocBuckets(int capacity) {
+    IdIndexEntry *b = malloc((size_t)capacity * sizeof(IdIndexEntry));
+    if (!b) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < capacity; i++) {
+        b[i].value = -1;
+    }
+    return b;
+}
+
+/* Place an entry into a table known to contain no copy of the key */
+static void insertFresh(IdIndexEntry *buckets, int capacity, int key, int value) {
+    unsigned int mask = (unsigned int)capacity - 1;
+    unsigned int i = hashKey(key) & mask;
+    while (buckets[i].value != -1) {
+        i = (i + 1) & mask;
+    }
+    buckets[i].key   = key;
+    buckets[i].value = value;
+}
+
+static void rehash(IdIndex *ix, int newCap) {
+    IdIndexEntry *nb = allocBuckets(newCap);
+    for (int i = 0; i < ix->capacity; i++) {
+        if (ix->buckets[i].value != -1) {
+            insertFresh(nb, newCap, ix->buckets[i].key, ix->buckets[i].value);
+        }
+    }
+    free(ix->buckets);
+    ix->buckets  = nb;
+    ix->capacity = newCap;
+}
+
+/* Bucket holding key, or -1 */
+static int findBucket(const IdIndex *ix, int key) {
+    if (ix->capacity == 0) return -1;
+    unsigned int mask = (unsigned int)ix->capacity - 1;
+    unsigned int i = hashKey(key) & mask;
+    while (ix->buckets[i].value != -1) {
+        if (ix->buckets[i].key == key)
+            return (int)i;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+/* ===================== Public API ===================== */
+
+void idIndexInit(IdIndex *ix) {
+    ix->buckets  = NULL;
+    ix->capacity = 0;
+    ix->count    = 0;
+}
+
+void idIndexFree(IdIndex *ix) {
+    free(ix->buckets);
+    idIndexInit(ix);
+}
+
+void idIndexClear(IdIndex *ix) {
+    for (int i = 0; i < ix->capacity; i++) {
+        ix->buckets[i].value = -1;
+    }
+    ix->count = 0;
+}
+
+void idIndexReserve(IdIndex *ix, int n) {
+    /* In long long: 2 * n overflows int for n above INT_MAX / 2 */
+    long long need = 16;
+    while (need < 2LL * n && need < IDINDEX_MAX_CAPACITY) need *= 2;
+    if (need > ix->capacity) {
+        rehash(ix, (int)need);
+    }
+}
+
+int idIndexGet(const IdIndex *ix, int key) {
+    int b = findBucket(ix, key);
+    return (b == -1) ? -1 : ix->buckets[b].value;
+}
+
+void idIndexPut(IdIndex *ix, int key, int value) {
+    int b = findBucket(ix, key);
+    if (b != -1) {
+        ix->buckets[b].value = value;
+        return;
+    }
+    if (2 * (ix->count + 1) > ix->capacity) {
+        rehash(ix, ix->capacity == 0 ? 16 : ix->capacity * 2);
+    }
+    insertFresh(ix->buckets, ix->capacity, key, value);
+    ix->count++;
+}
+
+void idIndexRemove(IdIndex *ix, int key) {
+    int b = findBucket(ix, key);
+    if (b == -1) return;
+
+    /* Backward-shift deletion: pull later entries of the probe run into the hole */
+    unsigned int mask = (unsigned int)ix->capacity - 1;
+    unsigned int hole = (unsigned int)b;
+    unsigned int j = hole;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (ix->buckets[j].value == -1)
+            break;
+        unsigned int home = hashKey(ix->buckets[j].key) & mask;
+        /* Entry at j may move into hole only if its home is not in (hole, j] */
+        int inRange = (hole <= j) ? (home > hole && home <= j)
+                                  : (home > hole || home <= j);
+        if (!inRange) {
+            ix->buckets[hole] = ix->buckets[j];
+            hole = j;
+        }
+    }
+    ix->buckets[hole].value = -1;
+    ix->count--;
+}
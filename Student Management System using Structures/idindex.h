@@ -0,0 +1,32 @@
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+/*
+ * Open-addressing hash index (linear probing):
+ *  - maps an integer key (student ID) to a non-negative value (array slot)
+ *  - stores slots, not pointers, so it survives realloc of the student array
+ *  - deletions use backward-shift, so no tombstones accumulate
+ *  - table is kept at most half full; lookups are O(1) on average
+ */
+#define IDINDEX_MAX_CAPACITY (1 << 30)  /* largest power of two in an int */
+typedef struct {
+    int key;
+    int value;  /* -1 marks an empty bucket */
+} IdIndexEntry;
+
+typedef struct {
+    IdIndexEntry *buckets;
+    int           capacity;  /* always a power of two (or 0) */
+    int           count;
+} IdIndex;
+
+void idIndexInit(IdIndex *ix);
+void idIndexFree(IdIndex *ix);
+void idIndexClear(IdIndex *ix);
+void idIndexReserve(IdIndex *ix, int n);  /* pre-size for n keys (capped) */
+
+int  idIndexGet(const IdIndex *ix, int key);         /* value, or -1 if absent */
+void idIndexPut(IdIndex *ix, int key, int value);    /* insert or overwrite */
+void idIndexRemove(IdIndex *ix, int key);
+
+#endif /* IDINDEX_H */
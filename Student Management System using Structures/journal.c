@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "journal.h"
+#include "snapshot.h"
+
+#define JOURNAL_MAGIC 0x4c4e524aU  /* "JRNL" */
+
+/* ===================== Internal Helpers ===================== */
+
+/* Field by field, so padding bytes (which a struct copy need not
+   preserve) never reach the checksum */
+static uint64_t recordChecksum(const JournalRecord *r) {
+    const Student *s = &r->student;
+    uint64_t h = snapshotChecksum(&r->op, sizeof(r->op));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(&r->lsn, sizeof(r->lsn));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(&s->id, sizeof(s->id));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(s->name, sizeof(s->name));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(&s->age, sizeof(s->age));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(s->course, sizeof(s->course));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(&s->numGrades, sizeof(s->numGrades));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(s->grades, sizeof(s->grades));
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(&s->gpa, sizeof(s->gpa));
+    return h;
+}
+
+static int recordIsValid(const JournalRecord *r) {
+    return r->magic == JOURNAL_MAGIC &&
+           r->op >= JOURNAL_ADD && r->op <= JOURNAL_DELETE &&
+           r->checksum == recordChecksum(r);
+}
+
+static int writeAll(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+            return -1;
+        p   += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int openForAppend(Journal *j) {
+    j->fd = open(j->filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (j->fd < 0) {
+        printf("Error: could not open journal '%s'.\n", j->filename);
+        return -1;
+    }
+    return 0;
+}
+
+/* ===================== Public API ===================== */
+
+int journalOpen(Journal *j, const char *filename, uint64_t afterLsn, JournalApplyFn apply) {
+    snprintf(j->filename, sizeof(j->filename), "%s", filename);
+    j->fd      = -1;
+    j->lastLsn = afterLsn;
+    j->size    = 0;
+
+    int applied = 0;
+    FILE *fp = fopen(filename, "rb");
+    if (fp) {
+        JournalRecord r;
+        while (fread(&r, sizeof(r), 1, fp) == 1 && recordIsValid(&r)) {
+            if (r.lsn > afterLsn) {
+                apply((JournalOp)r.op, &r.student);
+                applied++;
+            }
+            if (r.lsn > j->lastLsn)
+                j->lastLsn = r.lsn;
+            j->size += (long)sizeof(r);
+        }
+        fclose(fp);
+    }
+
+    if (openForAppend(j) != 0)
+        return -1;
+    /* Cut off a torn or corrupt tail so new records stay reachable */
+    if (ftruncate(j->fd, j->size) != 0) {
+        printf("Error: could not repair journal '%s'.\n", filename);
+        journalClose(j);
+        return -1;
+    }
+    return applied;
+}
+
+int journalAppend(Journal *j, JournalOp op, const Student *s) {
+    if (j->fd < 0)
+        return -1;
+
+    JournalRecord r;
+    memset(&r, 0, sizeof(r));
+    r.magic    = JOURNAL_MAGIC;
+    r.op       = (uint32_t)op;
+    r.lsn      = j->lastLsn + 1;
+    r.student  = *s;
+    r.checksum = recordChecksum(&r);
+
+    if (writeAll(j->fd, &r, sizeof(r)) != 0 || fsync(j->fd) != 0) {
+        printf("Error: failed to write journal '%s'.\n", j->filename);
+        if (ftruncate(j->fd, j->size) != 0) { /* best effort */ }
+        return -1;
+    }
+    j->lastLsn = r.lsn;
+    j->size   += (long)sizeof(r);
+    return 0;
+}
+
+int journalTrim(Journal *j, uint64_t uptoLsn) {
+    char tmpName[300];
+    snprintf(tmpName, sizeof(tmpName), "%s.tmp", j->filename);
+
+    FILE *in  = fopen(j->filename, "rb");
+    FILE *out = fopen(tmpName, "wb");
+    if (!in || !out) {
+        if (in) fclose(in);
+        if (out) fclose(out);
+        printf("Error: could not compact journal '%s'.\n", j->filename);
+        return -1;
+    }
+
+    long kept = 0;
+    int ok = 1;
+    JournalRecord r;
+    while (ok && fread(&r, sizeof(r), 1, in) == 1 && recordIsValid(&r)) {
+        if (r.lsn > uptoLsn) {
+            ok = fwrite(&r, sizeof(r), 1, out) == 1;
+            kept += (long)sizeof(r);
+        }
+    }
+    fclose(in);
+    if (ok)
+        ok = fflush(out) == 0 && fsync(fileno(out)) == 0;
+    if (fclose(out) != 0)
+        ok = 0;
+
+    if (!ok || rename(tmpName, j->filename) != 0) {
+        printf("Error: could not compact journal '%s'.\n", j->filename);
+        remove(tmpName);
+        return -1;
+    }
+
+    close(j->fd);
+    j->size = kept;
+    return openForAppend(j);
+}
+
+void journalClose(Journal *j) {
+    if (j->fd >= 0)
+        close(j->fd);
+    j->fd = -1;
+}
@@ -0,0 +1,58 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+#include "student.h"
+
+#define JOURNAL_FILE          "students.journal"
+#ifndef JOURNAL_COMPACT_BYTES
+#define JOURNAL_COMPACT_BYTES (4L * 1024 * 1024)  /* fold into snapshot past this size */
+#endif
+
+/*
+ * Append-only write-ahead journal of student mutations.
+ *  - every record carries a log sequence number (LSN) and a checksum
+ *  - records are fsync'd before the change is applied in memory
+ *  - a snapshot stores the LSN it covers, so replay skips older records
+ *  - a torn record at the tail (crash mid-write) is dropped on open
+ */
+typedef enum {
+    JOURNAL_ADD    = 1,
+    JOURNAL_UPDATE = 2,
+    JOURNAL_DELETE = 3   /* only student.id is meaningful */
+} JournalOp;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t op;
+    uint64_t lsn;
+    uint64_t checksum;   /* covers op, lsn and each student field */
+    Student  student;
+} JournalRecord;
+
+typedef struct {
+    int      fd;
+    char     filename[256];
+    uint64_t lastLsn;    /* highest LSN written or replayed */
+    long     size;       /* bytes currently in the file */
+} Journal;
+
+/* Called for each replayed record newer than the snapshot */
+typedef void (*JournalApplyFn)(JournalOp op, const Student *s);
+
+/*
+ * Open (creating if needed) the journal for appending, after replaying
+ * every valid record with lsn > afterLsn through apply.
+ * Returns the number of records applied, or -1 on error.
+ */
+int  journalOpen(Journal *j, const char *filename, uint64_t afterLsn, JournalApplyFn apply);
+
+/* Append one record with the next LSN and fsync it. Returns 0 on success. */
+int  journalAppend(Journal *j, JournalOp op, const Student *s);
+
+/* Drop records with lsn <= uptoLsn (they are covered by a snapshot). */
+int  journalTrim(Journal *j, uint64_t uptoLsn);
+
+void journalClose(Journal *j);
+
+#endif /* JOURNAL_H */
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "keysort.h"
+#include "alloc.h"
+
+#define SMALL_SORT 32  /* insertion sort below this many pairs */
+
+/* ===================== Internal Helpers ===================== */
+
+static void insertionSortKeys(SortKey *keys, int n) {
+    for (int i = 1; i < n; i++) {
+        SortKey k = keys[i];
+        int j = i - 1;
+        while (j >= 0 && keys[j].key > k.key) {
+            keys[j + 1] = keys[j];
+            j--;
+        }
+        keys[j + 1] = k;
+    }
+}
+
+/* Stable merge sort of one run using the tie comparator */
+static void mergeSortRun(SortKey *a, SortKey *tmp, int n, SortTieCmp cmp, const void *ctx) {
+    if (n < SMALL_SORT) {
+        for (int i = 1; i < n; i++) {
+            SortKey k = a[i];
+            int j = i - 1;
+            while (j >= 0 && cmp(ctx, a[j].index, k.index) > 0) {
+                a[j + 1] = a[j];
+                j--;
+            }
+            a[j + 1] = k;
+        }
+        return;
+    }
+    int mid = n / 2;
+    mergeSortRun(a, tmp, mid, cmp, ctx);
+    mergeSortRun(a + mid, tmp, n - mid, cmp, ctx);
+
+    int i = 0, j = mid, k = 0;
+    while (i < mid && j < n) {
+        if (cmp(ctx, a[j].index, a[i].index) < 0)
+            tmp[k++] = a[j++];
+        else
+            tmp[k++] = a[i++];
+    }
+    while (i < mid) tmp[k++] = a[i++];
+    while (j < n)   tmp[k++] = a[j++];
+    memcpy(a, tmp, (size_t)n * sizeof(SortKey));
+}
+
+/* ===================== Public API ===================== */
+
+void keySort(SortKey *keys, int n) {
+    if (n < SMALL_SORT) {
+        insertionSortKeys(keys, n);
+        return;
+    }
+
+    /* One pass builds the histograms for all eight digits */
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < n; i++) {
+        uint64_t k = keys[i].key;
+        for (int d = 0; d < 8; d++)
+            counts[d][(k >> (8 * d)) & 0xFF]++;
+    }
+
+    SortKey *tmp = allocOrDie((size_t)n * sizeof(SortKey));
+    SortKey *src = keys, *dst = tmp;
+    for (int d = 0; d < 8; d++) {
+        size_t *c = counts[d];
+        /* Skip digits that are the same for every key */
+        if (c[(keys[0].key >> (8 * d)) & 0xFF] == (size_t)n)
+            continue;
+
+        size_t pos = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t t = c[b];
+            c[b] = pos;
+            pos += t;
+        }
+        for (int i = 0; i < n; i++) {
+            dst[c[(src[i].key >> (8 * d)) & 0xFF]++] = src[i];
+        }
+        SortKey *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != keys)
+        memcpy(keys, src, (size_t)n * sizeof(SortKey));
+    free(tmp);
+}
+
+void keySortTies(SortKey *keys, int n, SortTieCmp cmp, const void *ctx) {
+    SortKey *tmp = NULL;
+    int start = 0;
+    while (start < n) {
+        int end = start + 1;
+        while (end < n && keys[end].key == keys[start].key)
+            end++;
+        if (end - start > 1) {
+            if (!tmp)
+                tmp = allocOrDie((size_t)n * sizeof(SortKey));
+            mergeSortRun(keys + start, tmp, end - start, cmp, ctx);
+        }
+        start = end;
+    }
+    free(tmp);
+}
+
+uint64_t sortKeyFromInt(int v) {
+    return (uint64_t)((uint32_t)v ^ 0x80000000U);
+}
+
+uint64_t sortKeyFromFloat(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    /* Negative floats: flip all bits; positive: flip the sign bit */
+    bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+    return (uint64_t)bits;
+}
+
+uint64_t sortKeyFromString(const char *s) {
+    uint64_t k = 0;
+    int ended = 0;
+    for (int i = 0; i < 8; i++) {
+        unsigned char c = ended ? 0 : (unsigned char)s[i];
+        if (c == 0) ended = 1;
+        k = (k << 8) | c;
+    }
+    return k;
+}
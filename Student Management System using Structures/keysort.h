@@ -0,0 +1,31 @@
+#ifndef KEYSORT_H
+#define KEYSORT_H
+
+#include <stdint.h>
+
+/*
+ * Sort engine over compact (key, index) pairs:
+ *  - callers encode each record's sort key as an order-preserving uint64
+ *    and sort the pairs instead of moving whole records
+ *  - keySort is a stable LSD radix sort (8-bit digits, constant digits skipped)
+ *  - keySortTies re-orders runs of equal keys with a comparator, for keys
+ *    (like names) that do not fit in 64 bits
+ *  - the sorted pairs give a permutation the caller applies once
+ */
+typedef struct {
+    uint64_t key;
+    int      index;  /* position of the record in the original array */
+} SortKey;
+
+/* Tie-break comparator: <0, 0, >0 like strcmp, on original record indices */
+typedef int (*SortTieCmp)(const void *ctx, int a, int b);
+
+void keySort(SortKey *keys, int n);
+void keySortTies(SortKey *keys, int n, SortTieCmp cmp, const void *ctx);
+
+/* Order-preserving key encodings */
+uint64_t sortKeyFromInt(int v);          /* ascending int */
+uint64_t sortKeyFromFloat(float v);      /* ascending float (total order) */
+uint64_t sortKeyFromString(const char *s); /* first 8 bytes, strcmp order */
+
+#endif /* KEYSORT_H */
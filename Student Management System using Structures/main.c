@@ -1,13 +1,40 @@
 #include <stdio.h>
+#include <string.h>
 #include "student.h"
 
+static void usage(const char *prog) {
+    printf("Usage: %s                     interactive menu\n", prog);
+    printf("       %s --import FILE.csv   bulk import id,name,age,course,grade...\n", prog);
+    printf("       %s --batch FILE        run a command file (see batch.c)\n", prog);
+    printf("       %s --serve SOCKET      serve queries on a Unix socket (see server.c)\n", prog);
+}
+
 /*
  * Main menu for the Student Management System.
  * Delegates all logic to functions defined in student.c.
+ * With --import/--batch it runs non-interactively and exits;
+ * with --serve it answers clients on a Unix socket until stopped.
  */
-int main(void) {
+int main(int argc, char *argv[]) {
     int choice;
 
+    if (argc == 3 && (strcmp(argv[1], "--import") == 0 || strcmp(argv[1], "--batch") == 0)) {
+        initSystem();
+        int rc = (strcmp(argv[1], "--import") == 0) ? runImport(argv[2]) : runBatch(argv[2]);
+        cleanupSystem();
+        return (rc == 0) ? 0 : 1;
+    }
+    if (argc == 3 && strcmp(argv[1], "--serve") == 0) {
+        initSystem();
+        int rc = runServer(argv[2]);
+        cleanupSystem();
+        return (rc == 0) ? 0 : 1;
+    }
+    if (argc != 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
     initSystem();  /* load data from file and init dynamic array */
 
     do {
@@ -18,8 +45,9 @@ int main(void) {
         printf("4. Delete Student\n");
         printf("5. Search / Sort\n");
         printf("6. Reports & Analytics\n");
-        printf("7. Save to File\n");
-        printf("8. Load from File\n");
+        printf("7. Export to Text File\n");
+        printf("8. Import from Text File\n");
+        printf("9. Compact Storage\n");
         printf("0. Exit\n");
         printf("=====================================\n");
         printf("Enter choice: ");
@@ -33,7 +61,11 @@ int main(void) {
             case 5: searchSortMenu(); break;
             case 6: reportsMenu(); break;
             case 7: saveToFile(DATA_FILE); break;
-            case 8: loadFromFile(DATA_FILE); break;
+            case 8:
+                loadFromFile(DATA_FILE);
+                saveSnapshot(SNAPSHOT_FILE);
+                break;
+            case 9: compactStorage(); break;
             case 0:
                 printf("Exiting...\n");
                 break;
@@ -0,0 +1,321 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nameindex.h"
+#include "alloc.h"
+
+/* ===================== Internal Helpers ===================== */
+
+static unsigned char foldChar(char c) {
+    return (unsigned char)tolower((unsigned char)c);
+}
+
+static int newNode(NameIndex *ix, unsigned char ch) {
+    int i;
+    if (ix->freeNode != -1) {
+        i = ix->freeNode;
+        ix->freeNode = ix->nodes[i].sibling;
+    } else {
+        if (ix->nodeCount == ix->nodeCap) {
+            ix->nodeCap = (ix->nodeCap == 0) ? 256 : ix->nodeCap * 2;
+            ix->nodes   = reallocOrDie(ix->nodes, (size_t)ix->nodeCap * sizeof(NameTrieNode));
+        }
+        i = ix->nodeCount++;
+    }
+    NameTrieNode *n = &ix->nodes[i];
+    n->child    = -1;
+    n->sibling  = -1;
+    n->postings = -1;
+    n->count    = 0;
+    n->ch       = ch;
+    return i;
+}
+
+/* Detach child from node's sibling list */
+static void unlinkChild(NameIndex *ix, int node, int child) {
+    int *link = &ix->nodes[node].child;
+    while (*link != child) {
+        link = &ix->nodes[*link].sibling;
+    }
+    *link = ix->nodes[child].sibling;
+}
+
+static int newPosting(NameIndex *ix, int id, int next) {
+    int p;
+    if (ix->freePosting != -1) {
+        p = ix->freePosting;
+        ix->freePosting = ix->postings[p].next;
+    } else {
+        if (ix->postingCount == ix->postingCap) {
+            ix->postingCap = (ix->postingCap == 0) ? 256 : ix->postingCap * 2;
+            ix->postings   = reallocOrDie(ix->postings, (size_t)ix->postingCap * sizeof(NamePosting));
+        }
+        p = ix->postingCount++;
+    }
+    ix->postings[p].id   = id;
+    ix->postings[p].next = next;
+    return p;
+}
+
+/* Child of node labelled ch, or -1 */
+static int findChild(const NameIndex *ix, int node, unsigned char ch) {
+    int c = ix->nodes[node].child;
+    while (c != -1 && ix->nodes[c].ch < ch) {
+        c = ix->nodes[c].sibling;
+    }
+    return (c != -1 && ix->nodes[c].ch == ch) ? c : -1;
+}
+
+/* Child of node labelled ch, created in sorted position if missing */
+static int findOrAddChild(NameIndex *ix, int node, unsigned char ch) {
+    int prev = -1;
+    int c = ix->nodes[node].child;
+    while (c != -1 && ix->nodes[c].ch < ch) {
+        prev = c;
+        c = ix->nodes[c].sibling;
+    }
+    if (c != -1 && ix->nodes[c].ch == ch)
+        return c;
+
+    int n = newNode(ix, ch);  /* may move ix->nodes */
+    ix->nodes[n].sibling = c;
+    if (prev == -1)
+        ix->nodes[node].child = n;
+    else
+        ix->nodes[prev].sibling = n;
+    return n;
+}
+
+/* Node reached by the folded key, or -1 */
+static int findNode(const NameIndex *ix, const char *key) {
+    if (ix->nodeCount == 0)
+        return -1;
+    int node = 0;
+    for (const char *p = key; *p && node != -1; p++) {
+        node = findChild(ix, node, foldChar(*p));
+    }
+    return node;
+}
+
+/* Copy up to max IDs stored at node into out[*written...] */
+static void emitPostings(const NameIndex *ix, int node, int *out, int max, int *written) {
+    for (int p = ix->nodes[node].postings; p != -1 && *written < max; p = ix->postings[p].next) {
+        out[(*written)++] = ix->postings[p].id;
+    }
+}
+
+/* Pre-order walk of a subtree, so matches come out in alphabetical order */
+static void collectSubtree(const NameIndex *ix, int node, int *out, int max, int *written) {
+    emitPostings(ix, node, out, max, written);
+    for (int c = ix->nodes[node].child; c != -1 && *written < max; c = ix->nodes[c].sibling) {
+        if (ix->nodes[c].count > 0)
+            collectSubtree(ix, c, out, max, written);
+    }
+}
+
+typedef struct {
+    const unsigned char *query;
+    int                  queryLen;
+    int                  maxDist;
+    int                 *outIds;
+    int                 *outDist;
+    int                  max;
+    int                  written;
+    int                  total;
+} FuzzySearch;
+
+/* Record a match, displacing the farthest kept one when the output is full */
+static void fuzzyEmit(FuzzySearch *fs, int id, int dist) {
+    fs->total++;
+    if (fs->written < fs->max) {
+        fs->outIds[fs->written]  = id;
+        fs->outDist[fs->written] = dist;
+        fs->written++;
+        return;
+    }
+    int worst = -1;
+    for (int i = 0; i < fs->written; i++) {
+        if (fs->outDist[i] > dist && (worst == -1 || fs->outDist[i] > fs->outDist[worst]))
+            worst = i;
+    }
+    if (worst != -1) {
+        fs->outIds[worst]  = id;
+        fs->outDist[worst] = dist;
+    }
+}
+
+/*
+ * Visit the children of node. prevRow[j] is the edit distance between the
+ * key spelled so far and the first j query characters (Levenshtein DP).
+ */
+static void fuzzyWalk(const NameIndex *ix, int node, const int *prevRow, FuzzySearch *fs) {
+    int row[NAME_INDEX_MAX_QUERY + 1];
+    int n = fs->queryLen;
+
+    for (int c = ix->nodes[node].child; c != -1; c = ix->nodes[c].sibling) {
+        const NameTrieNode *child = &ix->nodes[c];
+        if (child->count == 0)
+            continue;
+
+        row[0] = prevRow[0] + 1;
+        int best = row[0];
+        for (int j = 1; j <= n; j++) {
+            int sub = prevRow[j - 1] + (fs->query[j - 1] != child->ch);
+            int del = prevRow[j] + 1;
+            int ins = row[j - 1] + 1;
+            int d = sub < del ? sub : del;
+            row[j] = d < ins ? d : ins;
+            if (row[j] < best) best = row[j];
+        }
+
+        if (row[n] <= fs->maxDist) {
+            for (int p = child->postings; p != -1; p = ix->postings[p].next) {
+                fuzzyEmit(fs, ix->postings[p].id, row[n]);
+            }
+        }
+        /* Every extension of this key is at least `best` edits away */
+        if (best <= fs->maxDist)
+            fuzzyWalk(ix, c, row, fs);
+    }
+}
+
+/* ===================== Public API ===================== */
+
+void nameIndexInit(NameIndex *ix) {
+    ix->nodes        = NULL;
+    ix->nodeCount    = 0;
+    ix->nodeCap      = 0;
+    ix->freeNode     = -1;
+    ix->postings     = NULL;
+    ix->postingCount = 0;
+    ix->postingCap   = 0;
+    ix->freePosting  = -1;
+}
+
+void nameIndexFree(NameIndex *ix) {
+    free(ix->nodes);
+    free(ix->postings);
+    nameIndexInit(ix);
+}
+
+void nameIndexClear(NameIndex *ix) {
+    ix->nodeCount    = 0;
+    ix->freeNode     = -1;
+    ix->postingCount = 0;
+    ix->freePosting  = -1;
+}
+
+void nameIndexAdd(NameIndex *ix, const char *name, int id) {
+    if (ix->nodeCount == 0)
+        newNode(ix, 0);
+    int node = 0;
+    ix->nodes[0].count++;
+    for (const char *p = name; *p; p++) {
+        node = findOrAddChild(ix, node, foldChar(*p));
+        ix->nodes[node].count++;
+    }
+    int head = newPosting(ix, id, ix->nodes[node].postings);
+    ix->nodes[node].postings = head;
+}
+
+void nameIndexRemove(NameIndex *ix, const char *name, int id) {
+    int node = findNode(ix, name);
+    if (node == -1)
+        return;
+
+    int prev = -1;
+    int p = ix->nodes[node].postings;
+    while (p != -1 && ix->postings[p].id != id) {
+        prev = p;
+        p = ix->postings[p].next;
+    }
+    if (p == -1)
+        return;
+    if (prev == -1)
+        ix->nodes[node].postings = ix->postings[p].next;
+    else
+        ix->postings[prev].next = ix->postings[p].next;
+    ix->postings[p].next = ix->freePosting;
+    ix->freePosting = p;
+
+    /* Walk the path again to drop the subtree counts. Below the first node
+       left empty the path holds nothing else (emptied nodes never stay
+       linked), so that node and the rest of the path are recycled. */
+    int parent = 0;
+    ix->nodes[0].count--;
+    const char *c = name;
+    for (; *c; c++) {
+        node = findChild(ix, parent, foldChar(*c));
+        if (--ix->nodes[node].count == 0)
+            break;
+        parent = node;
+    }
+    if (*c == '\0')
+        return;
+    unlinkChild(ix, parent, node);
+    while (node != -1) {
+        int next = c[1] ? findChild(ix, node, foldChar(c[1])) : -1;
+        ix->nodes[node].sibling = ix->freeNode;
+        ix->freeNode = node;
+        node = next;
+        c++;
+    }
+}
+
+int nameIndexExact(const NameIndex *ix, const char *name, int *outIds, int max) {
+    int node = findNode(ix, name);
+    if (node == -1)
+        return 0;
+    int written = 0, total = 0;
+    for (int p = ix->nodes[node].postings; p != -1; p = ix->postings[p].next) {
+        total++;
+    }
+    emitPostings(ix, node, outIds, max, &written);
+    return total;
+}
+
+int nameIndexPrefix(const NameIndex *ix, const char *prefix, int *outIds, int max) {
+    int node = findNode(ix, prefix);
+    if (node == -1)
+        return 0;
+    int written = 0;
+    collectSubtree(ix, node, outIds, max, &written);
+    return ix->nodes[node].count;
+}
+
+int nameIndexFuzzy(const NameIndex *ix, const char *name, int maxDist,
+                   int *outIds, int *outDist, int max) {
+    unsigned char query[NAME_INDEX_MAX_QUERY];
+    int n = (int)strlen(name);
+    if (n > NAME_INDEX_MAX_QUERY || ix->nodeCount == 0 || maxDist < 0)
+        return 0;
+    for (int i = 0; i < n; i++) {
+        query[i] = foldChar(name[i]);
+    }
+
+    FuzzySearch fs = { query, n, maxDist, outIds, outDist, max, 0, 0 };
+    int row[NAME_INDEX_MAX_QUERY + 1];
+    for (int j = 0; j <= n; j++) {
+        row[j] = j;  /* empty key vs. the first j query characters */
+    }
+    if (n <= maxDist) {
+        for (int p = ix->nodes[0].postings; p != -1; p = ix->postings[p].next) {
+            fuzzyEmit(&fs, ix->postings[p].id, n);
+        }
+    }
+    fuzzyWalk(ix, 0, row, &fs);
+
+    /* Closest first; stable, so equal distances keep alphabetical order */
+    for (int i = 1; i < fs.written; i++) {
+        int id = outIds[i], d = outDist[i], j = i - 1;
+        while (j >= 0 && outDist[j] > d) {
+            outIds[j + 1]  = outIds[j];
+            outDist[j + 1] = outDist[j];
+            j--;
+        }
+        outIds[j + 1]  = id;
+        outDist[j + 1] = d;
+    }
+    return fs.total;
+}
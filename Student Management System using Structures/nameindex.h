@@ -0,0 +1,60 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+/*
+ * Name search index (trie over case-folded names):
+ *  - maps each name to the IDs of the students carrying it
+ *  - exact lookup is O(length); prefix lookup is O(length) plus the
+ *    matches returned, and the total match count is known up front
+ *  - fuzzy lookup walks the trie with one edit-distance row per level and
+ *    prunes every branch that is already too far from the query
+ *  - add/remove are O(length); a remove unlinks the nodes it leaves empty
+ *    and keeps them on a free list for the next add
+ * Names compare case-insensitively (ASCII).
+ */
+#define NAME_INDEX_MAX_QUERY 64  /* longer queries match nothing */
+
+typedef struct {
+    int           child;     /* first child, -1 if none; siblings sorted by ch */
+    int           sibling;   /* next sibling (or free node), -1 if none */
+    int           postings;  /* head of the ID list for the name ending here, -1 if none */
+    int           count;     /* IDs stored at or below this node */
+    unsigned char ch;
+} NameTrieNode;
+
+typedef struct {
+    int id;
+    int next;  /* next posting of the same name (or of the free list), -1 ends */
+} NamePosting;
+
+typedef struct {
+    NameTrieNode *nodes;          /* nodes[0] is the root */
+    int           nodeCount;
+    int           nodeCap;
+    int           freeNode;       /* head of the reusable nodes list */
+    NamePosting  *postings;
+    int           postingCount;
+    int           postingCap;
+    int           freePosting;    /* head of the reusable postings list */
+} NameIndex;
+
+void nameIndexInit(NameIndex *ix);
+void nameIndexFree(NameIndex *ix);
+void nameIndexClear(NameIndex *ix);
+
+void nameIndexAdd(NameIndex *ix, const char *name, int id);
+void nameIndexRemove(NameIndex *ix, const char *name, int id);
+
+/*
+ * Each lookup writes up to max matching IDs to outIds and returns the total
+ * number of matches (which may exceed max).
+ */
+int  nameIndexExact(const NameIndex *ix, const char *name, int *outIds, int max);
+int  nameIndexPrefix(const NameIndex *ix, const char *prefix, int *outIds, int max);
+
+/* Names within maxDist edits (insert, delete, substitute) of name; outDist
+   receives each match's distance and the output is ordered closest first */
+int  nameIndexFuzzy(const NameIndex *ix, const char *name, int maxDist,
+                    int *outIds, int *outDist, int max);
+
+#endif /* NAMEINDEX_H */
@@ -0,0 +1,438 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "orderedindex.h"
+#include "alloc.h"
+
+#define ORD_NODE_MIN  (ORD_NODE_MAX / 4)      /* below this a node is rebalanced */
+#define ORD_BUILD_FILL (ORD_NODE_MAX * 3 / 4)  /* bulk-built nodes leave room to grow */
+
+/* ===================== Internal Helpers ===================== */
+
+/* Node allocation may move the pools: re-fetch pointers after calling these */
+static int newLeaf(OrderedIndex *ix) {
+    int n;
+    if (ix->freeLeaf != -1) {
+        n = ix->freeLeaf;
+        ix->freeLeaf = ix->leaves[n].next;
+    } else {
+        if (ix->leafCount == ix->leafCap) {
+            ix->leafCap = (ix->leafCap == 0) ? 16 : ix->leafCap * 2;
+            ix->leaves  = reallocOrDie(ix->leaves, (size_t)ix->leafCap * sizeof(OrdLeaf));
+        }
+        n = ix->leafCount++;
+    }
+    ix->leaves[n].count = 0;
+    ix->leaves[n].next  = -1;
+    return n;
+}
+
+static int newInner(OrderedIndex *ix) {
+    int n;
+    if (ix->freeInner != -1) {
+        n = ix->freeInner;
+        ix->freeInner = ix->inners[n].child[0];
+    } else {
+        if (ix->innerCount == ix->innerCap) {
+            ix->innerCap = (ix->innerCap == 0) ? 16 : ix->innerCap * 2;
+            ix->inners   = reallocOrDie(ix->inners, (size_t)ix->innerCap * sizeof(OrdInner));
+        }
+        n = ix->innerCount++;
+    }
+    ix->inners[n].count = 0;
+    return n;
+}
+
+static void freeLeaf(OrderedIndex *ix, int n) {
+    ix->leaves[n].next = ix->freeLeaf;
+    ix->freeLeaf = n;
+}
+
+static void freeInner(OrderedIndex *ix, int n) {
+    ix->inners[n].child[0] = ix->freeInner;
+    ix->freeInner = n;
+}
+
+/* First position in keys[0..n) whose key is >= key (or > key when upper) */
+static int searchKeys(const uint64_t *keys, int n, uint64_t key, int upper) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (keys[mid] < key || (upper && keys[mid] == key))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Child of an inner node whose subtree may contain key */
+static int childFor(const OrdInner *in, uint64_t key) {
+    /* last i >= 1 with keys[i] <= key, else 0 */
+    int i = searchKeys(in->keys + 1, in->count - 1, key, 1);
+    return i;
+}
+
+/* Key count and lower bound of a node one level below an inner node */
+static int nodeSize(const OrderedIndex *ix, int node, int level) {
+    if (level == 0)
+        return ix->leaves[node].count;
+    int total = 0;
+    const OrdInner *in = &ix->inners[node];
+    for (int i = 0; i < in->count; i++) {
+        total += in->size[i];
+    }
+    return total;
+}
+
+static uint64_t nodeLowKey(const OrderedIndex *ix, int node, int level) {
+    return (level == 0) ? ix->leaves[node].keys[0] : ix->inners[node].keys[0];
+}
+
+static int nodeCount(const OrderedIndex *ix, int node, int level) {
+    return (level == 0) ? ix->leaves[node].count : ix->inners[node].count;
+}
+
+/* Open a gap at position pos of an inner node and fill it */
+static void innerInsertAt(OrdInner *in, int pos, uint64_t key, int child, int size) {
+    int tail = in->count - pos;
+    memmove(in->keys + pos + 1, in->keys + pos, (size_t)tail * sizeof(uint64_t));
+    memmove(in->child + pos + 1, in->child + pos, (size_t)tail * sizeof(int));
+    memmove(in->size + pos + 1, in->size + pos, (size_t)tail * sizeof(int));
+    in->keys[pos]  = key;
+    in->child[pos] = child;
+    in->size[pos]  = size;
+    in->count++;
+}
+
+static void innerRemoveAt(OrdInner *in, int pos) {
+    int tail = in->count - pos - 1;
+    memmove(in->keys + pos, in->keys + pos + 1, (size_t)tail * sizeof(uint64_t));
+    memmove(in->child + pos, in->child + pos + 1, (size_t)tail * sizeof(int));
+    memmove(in->size + pos, in->size + pos + 1, (size_t)tail * sizeof(int));
+    in->count--;
+}
+
+/*
+ * Insert key under node (a leaf when level == 0). Sets *added if the key
+ * was new. If the node had to split, returns the new right sibling and
+ * stores its lower bound in *sep; otherwise returns -1.
+ */
+static int insertAt(OrderedIndex *ix, int node, int level, uint64_t key,
+                    int *added, uint64_t *sep) {
+    if (level == 0) {
+        OrdLeaf *leaf = &ix->leaves[node];
+        int pos = searchKeys(leaf->keys, leaf->count, key, 0);
+        if (pos < leaf->count && leaf->keys[pos] == key)
+            return -1;
+        memmove(leaf->keys + pos + 1, leaf->keys + pos,
+                (size_t)(leaf->count - pos) * sizeof(uint64_t));
+        leaf->keys[pos] = key;
+        leaf->count++;
+        *added = 1;
+        if (leaf->count < ORD_NODE_MAX)
+            return -1;
+
+        int right = newLeaf(ix);
+        leaf = &ix->leaves[node];
+        OrdLeaf *r = &ix->leaves[right];
+        int half = leaf->count / 2;
+        r->count = leaf->count - half;
+        memcpy(r->keys, leaf->keys + half, (size_t)r->count * sizeof(uint64_t));
+        leaf->count = half;
+        r->next     = leaf->next;
+        leaf->next  = right;
+        *sep = r->keys[0];
+        return right;
+    }
+
+    int i = childFor(&ix->inners[node], key);
+    uint64_t childSep;
+    int split = insertAt(ix, ix->inners[node].child[i], level - 1, key, added, &childSep);
+    OrdInner *in = &ix->inners[node];
+    if (*added)
+        in->size[i]++;
+    if (split == -1)
+        return -1;
+
+    in->size[i] = nodeSize(ix, in->child[i], level - 1);
+    innerInsertAt(in, i + 1, childSep, split, nodeSize(ix, split, level - 1));
+    if (in->count < ORD_NODE_MAX)
+        return -1;
+
+    int right = newInner(ix);
+    in = &ix->inners[node];
+    OrdInner *r = &ix->inners[right];
+    int half = in->count / 2;
+    r->count = in->count - half;
+    memcpy(r->keys, in->keys + half, (size_t)r->count * sizeof(uint64_t));
+    memcpy(r->child, in->child + half, (size_t)r->count * sizeof(int));
+    memcpy(r->size, in->size + half, (size_t)r->count * sizeof(int));
+    in->count = half;
+    *sep = r->keys[0];
+    return right;
+}
+
+/*
+ * Children j and j+1 of parent sit at childLevel and one of them is
+ * under-full: merge them if they fit in one node, otherwise share the
+ * entries evenly.
+ */
+static void rebalance(OrderedIndex *ix, int parent, int j, int childLevel) {
+    OrdInner *p = &ix->inners[parent];
+    int a = p->child[j], b = p->child[j + 1];
+
+    if (childLevel == 0) {
+        OrdLeaf *la = &ix->leaves[a], *lb = &ix->leaves[b];
+        int total = la->count + lb->count;
+        if (total < ORD_NODE_MAX) {
+            memcpy(la->keys + la->count, lb->keys, (size_t)lb->count * sizeof(uint64_t));
+            la->count = total;
+            la->next  = lb->next;
+            freeLeaf(ix, b);
+            p->size[j] = total;
+            innerRemoveAt(p, j + 1);
+            return;
+        }
+        uint64_t tmp[2 * ORD_NODE_MAX];
+        memcpy(tmp, la->keys, (size_t)la->count * sizeof(uint64_t));
+        memcpy(tmp + la->count, lb->keys, (size_t)lb->count * sizeof(uint64_t));
+        int half = total / 2;
+        la->count = half;
+        lb->count = total - half;
+        memcpy(la->keys, tmp, (size_t)half * sizeof(uint64_t));
+        memcpy(lb->keys, tmp + half, (size_t)lb->count * sizeof(uint64_t));
+        p->keys[j + 1] = lb->keys[0];
+        p->size[j]     = la->count;
+        p->size[j + 1] = lb->count;
+        return;
+    }
+
+    OrdInner *ia = &ix->inners[a], *ib = &ix->inners[b];
+    ib->keys[0] = p->keys[j + 1];  /* pull the separator down as b's lower bound */
+    int total = ia->count + ib->count;
+    if (total < ORD_NODE_MAX) {
+        memcpy(ia->keys + ia->count, ib->keys, (size_t)ib->count * sizeof(uint64_t));
+        memcpy(ia->child + ia->count, ib->child, (size_t)ib->count * sizeof(int));
+        memcpy(ia->size + ia->count, ib->size, (size_t)ib->count * sizeof(int));
+        ia->count = total;
+        freeInner(ix, b);
+        p->size[j] += p->size[j + 1];
+        innerRemoveAt(p, j + 1);
+        return;
+    }
+
+    uint64_t keys[2 * ORD_NODE_MAX];
+    int      child[2 * ORD_NODE_MAX], size[2 * ORD_NODE_MAX];
+    memcpy(keys, ia->keys, (size_t)ia->count * sizeof(uint64_t));
+    memcpy(keys + ia->count, ib->keys, (size_t)ib->count * sizeof(uint64_t));
+    memcpy(child, ia->child, (size_t)ia->count * sizeof(int));
+    memcpy(child + ia->count, ib->child, (size_t)ib->count * sizeof(int));
+    memcpy(size, ia->size, (size_t)ia->count * sizeof(int));
+    memcpy(size + ia->count, ib->size, (size_t)ib->count * sizeof(int));
+    int half = total / 2;
+    ia->count = half;
+    ib->count = total - half;
+    memcpy(ia->keys, keys, (size_t)half * sizeof(uint64_t));
+    memcpy(ia->child, child, (size_t)half * sizeof(int));
+    memcpy(ia->size, size, (size_t)half * sizeof(int));
+    memcpy(ib->keys, keys + half, (size_t)ib->count * sizeof(uint64_t));
+    memcpy(ib->child, child + half, (size_t)ib->count * sizeof(int));
+    memcpy(ib->size, size + half, (size_t)ib->count * sizeof(int));
+    p->keys[j + 1] = ib->keys[0];
+    p->size[j]     = nodeSize(ix, a, childLevel);
+    p->size[j + 1] = nodeSize(ix, b, childLevel);
+}
+
+/* Remove key under node; returns 1 if it was present */
+static int removeAt(OrderedIndex *ix, int node, int level, uint64_t key) {
+    if (level == 0) {
+        OrdLeaf *leaf = &ix->leaves[node];
+        int pos = searchKeys(leaf->keys, leaf->count, key, 0);
+        if (pos == leaf->count || leaf->keys[pos] != key)
+            return 0;
+        memmove(leaf->keys + pos, leaf->keys + pos + 1,
+                (size_t)(leaf->count - pos - 1) * sizeof(uint64_t));
+        leaf->count--;
+        return 1;
+    }
+
+    OrdInner *in = &ix->inners[node];
+    int i = childFor(in, key);
+    if (!removeAt(ix, in->child[i], level - 1, key))
+        return 0;
+    in->size[i]--;
+    if (in->count > 1 && nodeCount(ix, in->child[i], level - 1) < ORD_NODE_MIN)
+        rebalance(ix, node, (i + 1 < in->count) ? i : i - 1, level - 1);
+    return 1;
+}
+
+/* Number of keys below key (or at most key, with inclusive) */
+static int rank(const OrderedIndex *ix, uint64_t key, int inclusive) {
+    if (ix->root == -1)
+        return 0;
+    int node = ix->root, r = 0;
+    for (int level = ix->height; level > 0; level--) {
+        const OrdInner *in = &ix->inners[node];
+        int i = childFor(in, key);
+        for (int c = 0; c < i; c++) {
+            r += in->size[c];
+        }
+        node = in->child[i];
+    }
+    const OrdLeaf *leaf = &ix->leaves[node];
+    return r + searchKeys(leaf->keys, leaf->count, key, inclusive);
+}
+
+/* ===================== Public API ===================== */
+
+void ordIndexInit(OrderedIndex *ix) {
+    ix->leaves     = NULL;
+    ix->leafCount  = 0;
+    ix->leafCap    = 0;
+    ix->freeLeaf   = -1;
+    ix->inners     = NULL;
+    ix->innerCount = 0;
+    ix->innerCap   = 0;
+    ix->freeInner  = -1;
+    ix->root       = -1;
+    ix->height     = 0;
+    ix->size       = 0;
+}
+
+void ordIndexFree(OrderedIndex *ix) {
+    free(ix->leaves);
+    free(ix->inners);
+    ordIndexInit(ix);
+}
+
+void ordIndexClear(OrderedIndex *ix) {
+    ix->leafCount  = 0;
+    ix->freeLeaf   = -1;
+    ix->innerCount = 0;
+    ix->freeInner  = -1;
+    ix->root       = -1;
+    ix->height     = 0;
+    ix->size       = 0;
+}
+
+void ordIndexBuild(OrderedIndex *ix, const uint64_t *keys, int n) {
+    ordIndexClear(ix);
+    if (n == 0)
+        return;
+
+    /* Leaves: spread the keys evenly, ORD_BUILD_FILL per leaf at most */
+    int nodes = (n + ORD_BUILD_FILL - 1) / ORD_BUILD_FILL;
+    int *level = reallocOrDie(NULL, (size_t)nodes * sizeof(int));
+    int done = 0, prev = -1;
+    for (int k = 0; k < nodes; k++) {
+        int take = n / nodes + (k < n % nodes);
+        int leaf = newLeaf(ix);
+        memcpy(ix->leaves[leaf].keys, keys + done, (size_t)take * sizeof(uint64_t));
+        ix->leaves[leaf].count = take;
+        if (prev != -1)
+            ix->leaves[prev].next = leaf;
+        prev = leaf;
+        level[k] = leaf;
+        done += take;
+    }
+
+    /* Inner levels, bottom up, until one node remains */
+    int height = 0;
+    while (nodes > 1) {
+        int parents = (nodes + ORD_BUILD_FILL - 1) / ORD_BUILD_FILL;
+        int used = 0;
+        for (int k = 0; k < parents; k++) {
+            int take = nodes / parents + (k < nodes % parents);
+            int in = newInner(ix);
+            OrdInner *p = &ix->inners[in];
+            for (int c = 0; c < take; c++) {
+                int child = level[used + c];
+                p->keys[c]  = nodeLowKey(ix, child, height);
+                p->child[c] = child;
+                p->size[c]  = nodeSize(ix, child, height);
+            }
+            p->count = take;
+            level[k] = in;
+            used += take;
+        }
+        nodes = parents;
+        height++;
+    }
+    ix->root   = level[0];
+    ix->height = height;
+    ix->size   = n;
+    free(level);
+}
+
+void ordIndexInsert(OrderedIndex *ix, uint64_t key) {
+    if (ix->root == -1) {
+        ix->root   = newLeaf(ix);
+        ix->height = 0;
+    }
+    int added = 0;
+    uint64_t sep;
+    int split = insertAt(ix, ix->root, ix->height, key, &added, &sep);
+    if (added)
+        ix->size++;
+    if (split == -1)
+        return;
+
+    /* Root split: grow the tree by one level */
+    int oldRoot = ix->root;
+    int root = newInner(ix);
+    OrdInner *r = &ix->inners[root];
+    r->count    = 2;
+    r->keys[0]  = nodeLowKey(ix, oldRoot, ix->height);
+    r->child[0] = oldRoot;
+    r->size[0]  = nodeSize(ix, oldRoot, ix->height);
+    r->keys[1]  = sep;
+    r->child[1] = split;
+    r->size[1]  = nodeSize(ix, split, ix->height);
+    ix->root = root;
+    ix->height++;
+}
+
+void ordIndexRemove(OrderedIndex *ix, uint64_t key) {
+    if (ix->root == -1 || !removeAt(ix, ix->root, ix->height, key))
+        return;
+    ix->size--;
+
+    /* Shrink the tree while the root has a single child */
+    while (ix->height > 0 && ix->inners[ix->root].count == 1) {
+        int old = ix->root;
+        ix->root = ix->inners[old].child[0];
+        freeInner(ix, old);
+        ix->height--;
+    }
+}
+
+int ordIndexCount(const OrderedIndex *ix, uint64_t lo, uint64_t hi) {
+    if (lo > hi)
+        return 0;
+    return rank(ix, hi, 1) - rank(ix, lo, 0);
+}
+
+int ordIndexRange(const OrderedIndex *ix, uint64_t lo, uint64_t hi, uint64_t *out, int max) {
+    int total = ordIndexCount(ix, lo, hi);
+    if (total == 0 || max <= 0)
+        return total;
+
+    /* Descend to the first key >= lo, then follow the leaf chain */
+    int node = ix->root;
+    for (int level = ix->height; level > 0; level--) {
+        const OrdInner *in = &ix->inners[node];
+        node = in->child[childFor(in, lo)];
+    }
+    int pos = searchKeys(ix->leaves[node].keys, ix->leaves[node].count, lo, 0);
+    int written = 0;
+    while (node != -1 && written < max && written < total) {
+        const OrdLeaf *leaf = &ix->leaves[node];
+        for (; pos < leaf->count && written < max && written < total; pos++) {
+            out[written++] = leaf->keys[pos];
+        }
+        node = leaf->next;
+        pos = 0;
+    }
+    return total;
+}
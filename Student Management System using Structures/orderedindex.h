@@ -0,0 +1,60 @@
+#ifndef ORDEREDINDEX_H
+#define ORDEREDINDEX_H
+
+#include <stdint.h>
+
+/*
+ * Ordered set of unique uint64 keys (counted B+tree):
+ *  - leaves hold sorted keys and are chained left to right
+ *  - inner nodes keep each child's lower bound and key count, so the
+ *    number of keys in a range is found in O(log n) without scanning
+ *  - insert/remove are O(log n); nodes split when full and merge with
+ *    (or borrow from) a neighbour when they drop below a quarter full
+ *  - a range query is O(log n + k) for k results
+ *  - nodes live in two pools addressed by index, so growth never
+ *    invalidates anything the tree stores
+ * Callers pack (value, id) into one key so equal values stay distinct.
+ */
+#define ORD_NODE_MAX 64  /* keys per leaf / children per inner node */
+
+typedef struct {
+    int      count;
+    int      next;                   /* next leaf in key order, -1 at the end */
+    uint64_t keys[ORD_NODE_MAX];
+} OrdLeaf;
+
+typedef struct {
+    int      count;                  /* number of children */
+    uint64_t keys[ORD_NODE_MAX];     /* keys[i] <= every key under child i (keys[0] unused by searches) */
+    int      child[ORD_NODE_MAX];    /* leaves when the node is on the lowest inner level */
+    int      size[ORD_NODE_MAX];     /* keys stored under child i */
+} OrdInner;
+
+typedef struct {
+    OrdLeaf  *leaves;
+    int       leafCount, leafCap, freeLeaf;     /* free leaves chain through next */
+    OrdInner *inners;
+    int       innerCount, innerCap, freeInner;  /* free inner nodes chain through child[0] */
+    int       root;    /* -1 while empty */
+    int       height;  /* 0: root is a leaf */
+    int       size;    /* keys stored */
+} OrderedIndex;
+
+void ordIndexInit(OrderedIndex *ix);
+void ordIndexFree(OrderedIndex *ix);
+void ordIndexClear(OrderedIndex *ix);
+
+/* Replace the contents with n ascending, distinct keys in O(n) */
+void ordIndexBuild(OrderedIndex *ix, const uint64_t *keys, int n);
+
+void ordIndexInsert(OrderedIndex *ix, uint64_t key);  /* no-op if present */
+void ordIndexRemove(OrderedIndex *ix, uint64_t key);  /* no-op if absent */
+
+/* Number of keys in [lo, hi] */
+int  ordIndexCount(const OrderedIndex *ix, uint64_t lo, uint64_t hi);
+
+/* Write up to max keys from [lo, hi] to out in ascending order; returns
+   the total number of keys in the range (which may exceed max) */
+int  ordIndexRange(const OrderedIndex *ix, uint64_t lo, uint64_t hi, uint64_t *out, int max);
+
+#endif /* ORDEREDINDEX_H */
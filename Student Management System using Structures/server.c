@@ -0,0 +1,358 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "student.h"
+#include "bulkload.h"
+
+#define SERVER_MAX_CLIENTS 128
+#define SERVER_MAX_LINE    1024
+#define SERVER_LIST_LIMIT  1000  /* records per reply; the full total is still reported */
+
+/* Connected clients, so a shutdown can wake every session thread */
+static int             clientFds[SERVER_MAX_CLIENTS];
+static int             clientCount = 0;
+static pthread_mutex_t clientLock  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  clientsGone = PTHREAD_COND_INITIALIZER;
+
+/* The signal handler writes here to wake the accept loop */
+static int stopPipe[2] = { -1, -1 };
+
+/* ===================== Internal Helpers ===================== */
+
+static void onStopSignal(int sig) {
+    (void)sig;
+    char c = 0;
+    ssize_t n = write(stopPipe[1], &c, 1);
+    (void)n;
+}
+
+static void replyError(FILE *out, const char *msg) {
+    fprintf(out, "ERR %s\n", msg);
+}
+
+/* OK <lines> <total>, then one "id name age course gpa" line per record */
+static void replyStudents(FILE *out, const Student *rows, int total) {
+    int shown = (total < SERVER_LIST_LIMIT) ? total : SERVER_LIST_LIMIT;
+    fprintf(out, "OK %d %d\n", shown, total);
+    for (int i = 0; i < shown; i++) {
+        fprintf(out, "%d %s %d %s %.2f\n", rows[i].id, rows[i].name, rows[i].age,
+                rows[i].course, rows[i].gpa);
+    }
+}
+
+static void replyStatus(FILE *out, StoreStatus rc) {
+    switch (rc) {
+        case STORE_OK:        fprintf(out, "OK 0 1\n"); break;
+        case STORE_NOT_FOUND: replyError(out, "student not found"); break;
+        case STORE_DUPLICATE: replyError(out, "student ID already exists"); break;
+        case STORE_IO_ERROR:  replyError(out, "change could not be saved"); break;
+    }
+}
+
+/* add|update <id> <name> <age> <course> <grade> [grade ...] */
+static void serveChange(int update, const char *fields, FILE *out) {
+    Student s;
+    const char *err;
+    if (bulkParseFields(fields, &s, &err) != 1) {
+        replyError(out, err);
+        return;
+    }
+    replyStatus(out, update ? storeUpdateStudent(&s) : storeInsertStudent(&s));
+}
+
+/* count|range gpa|age <lo> <hi> */
+static void serveRange(int list, const char *field, char **save, Student *rows, FILE *out) {
+    RangeField f;
+    float lo, hi;
+    if (field && strcmp(field, "gpa") == 0) {
+        f = RANGE_BY_GPA;
+    } else if (field && strcmp(field, "age") == 0) {
+        f = RANGE_BY_AGE;
+    } else {
+        replyError(out, "expected 'gpa' or 'age'");
+        return;
+    }
+    if (bulkParseFloatToken(strtok_r(NULL, " \t", save), &lo) != 0 ||
+        bulkParseFloatToken(strtok_r(NULL, " \t", save), &hi) != 0) {
+        replyError(out, "expected <lo> <hi>");
+        return;
+    }
+    if (!list) {
+        fprintf(out, "OK 0 %d\n", storeCountRange(f, lo, hi));
+        return;
+    }
+    replyStudents(out, rows, storeRangeQuery(f, lo, hi, rows, SERVER_LIST_LIMIT));
+}
+
+/* Run one request line; returns 1 when the client asked to quit */
+static int serveRequest(char *line, Student *rows, FILE *out) {
+    char *save = NULL;
+    char *cmd  = strtok_r(line, " \t", &save);
+    if (!cmd)
+        return 0;
+    if (strcmp(cmd, "add") == 0 || strcmp(cmd, "update") == 0) {
+        serveChange(cmd[0] == 'u', strtok_r(NULL, "", &save), out);
+        return 0;
+    }
+    char *arg = strtok_r(NULL, " \t", &save);
+    int   id, n;
+
+    if (strcmp(cmd, "get") == 0 && bulkParseIntToken(arg, &id) == 0) {
+        replyStudents(out, rows, storeGetStudent(id, rows) == 0 ? 1 : 0);
+    } else if ((strcmp(cmd, "name") == 0 || strcmp(cmd, "prefix") == 0) && arg) {
+        NameSearchMode mode = (cmd[0] == 'n') ? NAME_EXACT : NAME_PREFIX;
+        replyStudents(out, rows, storeFindByName(mode, arg, 0, rows, NULL, SERVER_LIST_LIMIT));
+    } else if (strcmp(cmd, "fuzzy") == 0 && arg) {
+        if (bulkParseIntToken(strtok_r(NULL, " \t", &save), &n) != 0 || n < 1 || n > 2) {
+            replyError(out, "expected <name> <typos 1-2>");
+            return 0;
+        }
+        replyStudents(out, rows, storeFindByName(NAME_FUZZY, arg, n, rows, NULL, SERVER_LIST_LIMIT));
+    } else if (strcmp(cmd, "count") == 0 || strcmp(cmd, "range") == 0) {
+        serveRange(cmd[0] == 'r', arg, &save, rows, out);
+    } else if (strcmp(cmd, "stats") == 0) {
+        StoreStats st;
+        if (storeStats(arg, &st) == 0) {
+            fprintf(out, "OK 0 0\n");
+        } else {
+            fprintf(out, "OK 1 %d\n%.2f %.2f %.2f %.1f\n",
+                    st.count, st.avgGpa, st.minGpa, st.maxGpa, st.avgAge);
+        }
+    } else if (strcmp(cmd, "top") == 0 && bulkParseIntToken(arg, &n) == 0 && n > 0) {
+        if (n > SERVER_LIST_LIMIT)
+            n = SERVER_LIST_LIMIT;
+        replyStudents(out, rows, storeTopStudents(strtok_r(NULL, " \t", &save), n, rows));
+    } else if (strcmp(cmd, "delete") == 0 && bulkParseIntToken(arg, &id) == 0) {
+        replyStatus(out, storeRemoveStudent(id));
+    } else if (strcmp(cmd, "quit") == 0) {
+        fprintf(out, "OK 0 0\n");
+        return 1;
+    } else {
+        replyError(out, "unknown or incomplete command");
+    }
+    return 0;
+}
+
+/* Answer one client's requests until it disconnects, quits or the server stops */
+static void *clientSession(void *arg) {
+    int slot = (int)(intptr_t)arg;
+    pthread_mutex_lock(&clientLock);
+    int fd = clientFds[slot];
+    pthread_mutex_unlock(&clientLock);
+
+    int   outFd = dup(fd);
+    FILE *in    = fdopen(fd, "r");
+    FILE *out   = (outFd >= 0) ? fdopen(outFd, "w") : NULL;
+    Student *rows = malloc(SERVER_LIST_LIMIT * sizeof(Student));
+    if (in && out && rows) {
+        char line[SERVER_MAX_LINE];
+        while (fgets(line, sizeof(line), in)) {
+            if (!strchr(line, '\n') && !feof(in)) {
+                /* Drop the rest of an overlong line */
+                int c;
+                while ((c = fgetc(in)) != EOF && c != '\n')
+                    ;
+                replyError(out, "line too long");
+            } else {
+                line[strcspn(line, "\r\n")] = '\0';
+                if (serveRequest(line, rows, out))
+                    break;
+            }
+            if (fflush(out) == EOF)
+                break;
+        }
+    }
+    free(rows);
+    if (out)
+        fclose(out);
+    else if (outFd >= 0)
+        close(outFd);
+
+    pthread_mutex_lock(&clientLock);
+    clientFds[slot] = -1;
+    if (--clientCount == 0)
+        pthread_cond_signal(&clientsGone);
+    pthread_mutex_unlock(&clientLock);
+    if (in)
+        fclose(in);
+    else
+        close(fd);
+    return NULL;
+}
+
+/* Hand a new connection to its own thread; refuses it when the server is full */
+static void startSession(int fd) {
+    pthread_mutex_lock(&clientLock);
+    int slot = -1;
+    for (int i = 0; i < SERVER_MAX_CLIENTS && slot == -1; i++) {
+        if (clientFds[i] == -1)
+            slot = i;
+    }
+    if (slot != -1) {
+        clientFds[slot] = fd;
+        clientCount++;
+    }
+    pthread_mutex_unlock(&clientLock);
+    if (slot == -1) {
+        static const char busy[] = "ERR server busy\n";
+        ssize_t n = write(fd, busy, sizeof(busy) - 1);
+        (void)n;
+        close(fd);
+        return;
+    }
+
+    /* Sessions leave SIGINT/SIGTERM to the accept loop */
+    sigset_t stop, old;
+    sigemptyset(&stop);
+    sigaddset(&stop, SIGINT);
+    sigaddset(&stop, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop, &old);
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int rc = pthread_create(&thread, &attr, clientSession, (void *)(intptr_t)slot);
+    pthread_attr_destroy(&attr);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (rc != 0) {
+        pthread_mutex_lock(&clientLock);
+        clientFds[slot] = -1;
+        if (--clientCount == 0)
+            pthread_cond_signal(&clientsGone);
+        pthread_mutex_unlock(&clientLock);
+        close(fd);
+    }
+}
+
+/* Bind the listening socket, replacing a socket file left by a dead server */
+static int openListener(const char *socketPath) {
+    struct sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        printf("Error: socket path '%s' is too long.\n", socketPath);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Error: could not create socket.\n");
+        return -1;
+    }
+    int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    if (rc != 0 && errno == EADDRINUSE) {
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int alive = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe >= 0)
+            close(probe);
+        if (alive) {
+            printf("Error: a server is already listening on '%s'.\n", socketPath);
+            close(fd);
+            return -1;
+        }
+        unlink(socketPath);
+        rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    }
+    if (rc != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("Error: could not listen on '%s'.\n", socketPath);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ===================== Public API ===================== */
+
+/*
+ * Line protocol, one request per line:
+ *   get <id>
+ *   name <name> | prefix <text> | fuzzy <name> <typos 1-2>
+ *   count gpa|age <lo> <hi> | range gpa|age <lo> <hi>
+ *   stats [course] | top <n> [course]
+ *   add <id> <name> <age> <course> <grade> [grade ...]
+ *   update <id> <name> <age> <course> <grade> [grade ...]
+ *   delete <id>
+ *   quit
+ * Success is "OK <lines> <total>" followed by <lines> lines: records as
+ * "id name age course gpa", or for stats "avg min max avg_age" with the
+ * student count as total. Failure is a single "ERR <reason>" line.
+ * Each client gets its own thread; reads run against the store without
+ * waiting for writes, and every change is journaled before it is answered.
+ */
+int runServer(const char *socketPath) {
+    int listenFd = openListener(socketPath);
+    if (listenFd < 0)
+        return -1;
+    if (pipe(stopPipe) != 0) {
+        printf("Error: could not create pipe.\n");
+        close(listenFd);
+        unlink(socketPath);
+        return -1;
+    }
+    for (int i = 0; i < SERVER_MAX_CLIENTS; i++) {
+        clientFds[i] = -1;
+    }
+
+    struct sigaction sa, oldInt, oldTerm, oldPipe;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = onStopSignal;
+    sigaction(SIGINT, &sa, &oldInt);
+    sigaction(SIGTERM, &sa, &oldTerm);
+    sa.sa_handler = SIG_IGN;  /* a vanished client is an I/O error, not a crash */
+    sigaction(SIGPIPE, &sa, &oldPipe);
+
+    StoreStats st;
+    printf("Serving %d student(s) on '%s' (Ctrl+C to stop).\n", storeStats(NULL, &st), socketPath);
+    fflush(stdout);
+
+    struct pollfd fds[2] = { { listenFd, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break;
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listenFd, NULL, NULL);
+            if (fd >= 0)
+                startSession(fd);
+        }
+    }
+
+    /* Wake every session and wait for it to finish its current request */
+    pthread_mutex_lock(&clientLock);
+    for (int i = 0; i < SERVER_MAX_CLIENTS; i++) {
+        if (clientFds[i] != -1)
+            shutdown(clientFds[i], SHUT_RDWR);
+    }
+    while (clientCount > 0)
+        pthread_cond_wait(&clientsGone, &clientLock);
+    pthread_mutex_unlock(&clientLock);
+
+    close(listenFd);
+    unlink(socketPath);
+    sigaction(SIGINT, &oldInt, NULL);
+    sigaction(SIGTERM, &oldTerm, NULL);
+    sigaction(SIGPIPE, &oldPipe, NULL);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    stopPipe[0] = stopPipe[1] = -1;
+    printf("Server stopped.\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "snapshot.h"
+
+static const char snapshotMagic[8] = "STUSNAP";
+
+/* ===================== Internal Helpers ===================== */
+
+/* Combined checksum of the three body sections */
+static uint64_t sectionsChecksum(const void *records, size_t recordBytes,
+                                 const char *courses, size_t courseBytes,
+                                 const char *names, size_t nameBytes) {
+    uint64_t h = snapshotChecksum(records, recordBytes);
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(courses, courseBytes);
+    h = h * 0x100000001b3ULL ^ snapshotChecksum(names, nameBytes);
+    return h;
+}
+
+/* ===================== Public API ===================== */
+
+/* FNV-1a style checksum, folded 8 bytes at a time (shared with the journal) */
+uint64_t snapshotChecksum(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        h ^= w;
+        h *= 0x100000001b3ULL;
+    }
+    for (; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h ^ (uint64_t)len;
+}
+
+int snapshotWrite(const char *filename, const SnapshotData *d, uint64_t lsn) {
+    char tmpName[512];
+    snprintf(tmpName, sizeof(tmpName), "%s.tmp", filename);
+
+    FILE *fp = fopen(tmpName, "wb");
+    if (!fp) {
+        printf("Error: could not open file '%s' for writing.\n", tmpName);
+        return -1;
+    }
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, snapshotMagic, sizeof(h.magic));
+    size_t recordBytes = (size_t)d->count * sizeof(StudentRecord);
+    h.version     = SNAPSHOT_VERSION;
+    h.recordSize  = (uint32_t)sizeof(StudentRecord);
+    h.count       = (uint64_t)d->count;
+    h.lsn         = lsn;
+    h.courseBytes = d->courseBytes;
+    h.nameBytes   = d->nameBytes;
+    h.courseCount = (uint32_t)d->courseCount;
+    h.checksum    = sectionsChecksum(d->records, recordBytes, d->courses, d->courseBytes,
+                                     d->names, d->nameBytes);
+
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+    if (ok && recordBytes > 0)
+        ok = fwrite(d->records, 1, recordBytes, fp) == recordBytes;
+    if (ok && d->courseBytes > 0)
+        ok = fwrite(d->courses, 1, d->courseBytes, fp) == d->courseBytes;
+    if (ok && d->nameBytes > 0)
+        ok = fwrite(d->names, 1, d->nameBytes, fp) == d->nameBytes;
+    if (ok)
+        ok = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    if (fclose(fp) != 0)
+        ok = 0;
+
+    if (!ok || rename(tmpName, filename) != 0) {
+        printf("Error: failed to write snapshot '%s'.\n", filename);
+        remove(tmpName);
+        return -1;
+    }
+    return 0;
+}
+
+int snapshotMap(const char *filename, SnapshotMapping *m) {
+    memset(m, 0, sizeof(*m));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return (errno == ENOENT) ? 1 : -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t len = (size_t)st.st_size;
+    /* Private writable mapping: in-place updates never touch the file */
+    void *base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return -1;
+
+    const SnapshotHeader *h = base;
+    char *body = (char *)base + sizeof(SnapshotHeader);
+    size_t bodyLen = len - sizeof(SnapshotHeader);
+    if (memcmp(h->magic, snapshotMagic, sizeof(h->magic)) != 0 ||
+        h->version != SNAPSHOT_VERSION ||
+        h->recordSize != sizeof(StudentRecord) ||
+        h->count > (uint64_t)INT_MAX ||
+        h->courseCount > (uint32_t)INT_MAX ||
+        h->courseBytes > bodyLen || h->nameBytes > bodyLen ||
+        bodyLen != h->count * sizeof(StudentRecord) + h->courseBytes + h->nameBytes) {
+        munmap(base, len);
+        return -1;
+    }
+
+    size_t recordBytes = (size_t)h->count * sizeof(StudentRecord);
+    SnapshotData *d = &m->data;
+    d->records     = (StudentRecord *)body;
+    d->count       = (int)h->count;
+    d->courses     = body + recordBytes;
+    d->courseBytes = (size_t)h->courseBytes;
+    d->courseCount = (int)h->courseCount;
+    d->names       = d->courses + d->courseBytes;
+    d->nameBytes   = (size_t)h->nameBytes;
+
+    /* Both string sections must end in a terminator so lookups stay in bounds */
+    size_t terminators = 0;
+    for (size_t i = 0; i < d->courseBytes; i++)
+        terminators += d->courses[i] == '\0';
+    if (sectionsChecksum(d->records, recordBytes, d->courses, d->courseBytes,
+                         d->names, d->nameBytes) != h->checksum ||
+        terminators != (size_t)d->courseCount ||
+        (d->courseBytes > 0 && d->courses[d->courseBytes - 1] != '\0') ||
+        (d->nameBytes > 0 && d->names[d->nameBytes - 1] != '\0')) {
+        munmap(base, len);
+        memset(m, 0, sizeof(*m));
+        return -1;
+    }
+
+    m->base   = base;
+    m->length = len;
+    m->lsn    = h->lsn;
+    return 0;
+}
+
+void snapshotUnmap(SnapshotMapping *m) {
+    if (m->base)
+        munmap(m->base, m->length);
+    memset(m, 0, sizeof(*m));
+}
@@ -0,0 +1,68 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "student.h"
+
+#define SNAPSHOT_VERSION 3
+
+/*
+ * Binary snapshot file layout (native byte order):
+ *  - SnapshotHeader (64 bytes)
+ *  - count * sizeof(StudentRecord) bytes: the record array exactly as in memory
+ *  - courseBytes: the course dictionary, courseCount NUL-terminated strings
+ *    in id order
+ *  - nameBytes: the name arena the records' nameRef offsets point into
+ *
+ * Because records are stored in their in-memory layout, a snapshot can be
+ * mmap'd and used as the students array directly, with no parsing.
+ * The checksum covers everything after the header; together with the size
+ * check it rejects truncated or corrupted files.
+ */
+typedef struct {
+    char     magic[8];      /* "STUSNAP" */
+    uint32_t version;       /* SNAPSHOT_VERSION */
+    uint32_t recordSize;    /* sizeof(StudentRecord) when written */
+    uint64_t count;         /* number of records */
+    uint64_t checksum;      /* checksum of the body */
+    uint64_t lsn;           /* last journal record folded into this snapshot */
+    uint64_t courseBytes;
+    uint64_t nameBytes;
+    uint32_t courseCount;
+    uint32_t reserved;
+} SnapshotHeader;
+
+/* The sections of one snapshot, as written or as found in a mapping */
+typedef struct {
+    StudentRecord *records;
+    int            count;
+    const char    *courses;      /* courseCount strings, back to back */
+    size_t         courseBytes;
+    int            courseCount;
+    const char    *names;        /* name arena */
+    size_t         nameBytes;
+} SnapshotData;
+
+/* A loaded snapshot: every section points into a private (copy-on-write) mapping */
+typedef struct {
+    void        *base;
+    size_t       length;
+    SnapshotData data;
+    uint64_t     lsn;
+} SnapshotMapping;
+
+/* Write a snapshot atomically (temp file + fsync + rename). Returns 0 on success. */
+int  snapshotWrite(const char *filename, const SnapshotData *d, uint64_t lsn);
+
+/*
+ * Map and validate a snapshot.
+ * Returns 0 on success, 1 if the file does not exist, -1 if it is invalid.
+ */
+int  snapshotMap(const char *filename, SnapshotMapping *m);
+void snapshotUnmap(SnapshotMapping *m);
+
+/* Checksum used for snapshot bodies and journal records */
+uint64_t snapshotChecksum(const void *data, size_t len);
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "strpool.h"
+#include "alloc.h"
+
+/* ===================== Internal Helpers ===================== */
+
+/* FNV-1a over the string bytes */
+static unsigned int hashString(const char *s) {
+    unsigned int h = 2166136261U;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static void rehash(StringPool *p, int newCap) {
+    p->buckets   = reallocOrDie(p->buckets, (size_t)newCap * sizeof(int));
+    p->bucketCap = newCap;
+    for (int i = 0; i < newCap; i++) {
+        p->buckets[i] = -1;
+    }
+    unsigned int mask = (unsigned int)newCap - 1;
+    for (int id = 0; id < p->count; id++) {
+        unsigned int i = hashString(p->strings[id]) & mask;
+        while (p->buckets[i] != -1) {
+            i = (i + 1) & mask;
+        }
+        p->buckets[i] = id;
+    }
+}
+
+/* Bucket holding s, or the empty bucket where it would go */
+static unsigned int findBucket(const StringPool *p, const char *s) {
+    unsigned int mask = (unsigned int)p->bucketCap - 1;
+    unsigned int i = hashString(s) & mask;
+    while (p->buckets[i] != -1 && strcmp(p->strings[p->buckets[i]], s) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/* ===================== Public API ===================== */
+
+void strPoolInit(StringPool *p) {
+    p->strings   = NULL;
+    p->count     = 0;
+    p->capacity  = 0;
+    p->buckets   = NULL;
+    p->bucketCap = 0;
+}
+
+void strPoolFree(StringPool *p) {
+    for (int i = 0; i < p->count; i++) {
+        free(p->strings[i]);
+    }
+    free(p->strings);
+    free(p->buckets);
+    strPoolInit(p);
+}
+
+int strPoolFind(const StringPool *p, const char *s) {
+    if (p->bucketCap == 0)
+        return -1;
+    return p->buckets[findBucket(p, s)];
+}
+
+int strPoolIntern(StringPool *p, const char *s) {
+    if (2 * (p->count + 1) > p->bucketCap) {
+        rehash(p, p->bucketCap == 0 ? 16 : p->bucketCap * 2);
+    }
+    unsigned int b = findBucket(p, s);
+    if (p->buckets[b] != -1)
+        return p->buckets[b];
+
+    if (p->count >= p->capacity) {
+        p->capacity = (p->capacity == 0) ? 16 : p->capacity * 2;
+        p->strings  = reallocOrDie(p->strings, (size_t)p->capacity * sizeof(char *));
+    }
+    size_t len = strlen(s) + 1;
+    char *copy = reallocOrDie(NULL, len);
+    memcpy(copy, s, len);
+
+    int id = p->count++;
+    p->strings[id] = copy;
+    p->buckets[b]  = id;
+    return id;
+}
+
+const char *strPoolGet(const StringPool *p, int id) {
+    return (id >= 0 && id < p->count) ? p->strings[id] : "";
+}
+
+/* ===================== String Arena ===================== */
+
+static void arenaReserve(StringArena *a, size_t needed) {
+    if (needed <= a->capacity)
+        return;
+    size_t newCap = (a->capacity == 0) ? 4096 : a->capacity;
+    while (newCap < needed) newCap *= 2;
+    if (newCap > UINT32_MAX) {
+        printf("Error: name storage is full!\n");
+        exit(EXIT_FAILURE);
+    }
+    a->data     = reallocOrDie(a->data, newCap);
+    a->capacity = newCap;
+}
+
+void strArenaInit(StringArena *a) {
+    a->data     = NULL;
+    a->used     = 0;
+    a->capacity = 0;
+}
+
+void strArenaFree(StringArena *a) {
+    free(a->data);
+    strArenaInit(a);
+}
+
+void strArenaClear(StringArena *a) {
+    a->used = 0;
+}
+
+uint32_t strArenaAdd(StringArena *a, const char *s) {
+    size_t len = strlen(s) + 1;
+    arenaReserve(a, a->used + len);
+    uint32_t offset = (uint32_t)a->used;
+    memcpy(a->data + offset, s, len);
+    a->used += len;
+    return offset;
+}
+
+void strArenaAssign(StringArena *a, const char *bytes, size_t len) {
+    arenaReserve(a, len);
+    if (len > 0)
+        memcpy(a->data, bytes, len);
+    a->used = len;
+}
+
+const char *strArenaGet(const StringArena *a, uint32_t offset) {
+    return (offset < a->used) ? a->data + offset : "";
+}
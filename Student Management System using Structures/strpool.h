@@ -0,0 +1,48 @@
+#ifndef STRPOOL_H
+#define STRPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * String pool (dictionary encoding):
+ *  - each distinct string gets a small, stable integer id (0, 1, 2, ...)
+ *  - ids are never reused, so they can be stored in columns and indexes
+ *  - lookups hash the string once; afterwards comparisons are integer compares
+ */
+typedef struct {
+    char **strings;     /* id -> owned copy of the string */
+    int    count;
+    int    capacity;
+    int   *buckets;     /* open-addressing table of ids, -1 = empty */
+    int    bucketCap;   /* power of two */
+} StringPool;
+
+void strPoolInit(StringPool *p);
+void strPoolFree(StringPool *p);
+
+int         strPoolIntern(StringPool *p, const char *s);      /* id, adding s if new */
+int         strPoolFind(const StringPool *p, const char *s);  /* id, or -1 */
+const char *strPoolGet(const StringPool *p, int id);
+
+/*
+ * String arena (append-only):
+ *  - strings are packed back to back, NUL-terminated, in one growable buffer
+ *  - a string is referred to by its byte offset, which survives realloc and
+ *    can be written to disk unchanged
+ *  - replaced strings are not reclaimed until the arena is rebuilt
+ */
+typedef struct {
+    char  *data;
+    size_t used;
+    size_t capacity;
+} StringArena;
+
+void        strArenaInit(StringArena *a);
+void        strArenaFree(StringArena *a);
+void        strArenaClear(StringArena *a);
+uint32_t    strArenaAdd(StringArena *a, const char *s);             /* offset of the copy */
+void        strArenaAssign(StringArena *a, const char *bytes, size_t len);  /* replace contents */
+const char *strArenaGet(const StringArena *a, uint32_t offset);
+
+#endif /* STRPOOL_H */
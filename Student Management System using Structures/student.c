@@ -1,28 +1,225 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "student.h"
-
-/* Dynamic storage for students (only visible inside this file) */
-static Student *students      = NULL;
-static int      studentCount  = 0;
-static int      capacity      = 0;
+#include "bulkload.h"
+#include "columns.h"
+#include "courseagg.h"
+#include "gpastats.h"
+#include "idindex.h"
+#include "journal.h"
+#include "keysort.h"
+#include "nameindex.h"
+#include "orderedindex.h"
+#include "snapshot.h"
+#include "strpool.h"
+#include "topn.h"
+
+/*
+ * One copy of the store: the records and everything derived from them.
+ * Deleted records leave a tombstone (DEAD_ROW in the course column) and
+ * their slot goes on a free list for the next insert; the array is
+ * compacted once tombstones make up too large a share of it.
+ */
+typedef struct {
+    StudentRecord   *students;
+    int              slotCount;     /* slots in use, live or tombstoned */
+    int              studentCount;  /* live records */
+    int              capacity;
+    int             *freeSlots;
+    int              freeCount;
+    int              freeCap;
+    IdIndex          idIndex;       /* student ID -> slot in students[] */
+    StringPool       courses;       /* course dictionary */
+    StringArena      names;
+    StudentColumns   columns;       /* columnar mirror, row i == students[i] */
+    NameIndex        nameIndex;     /* names -> IDs for exact, prefix and fuzzy search */
+    OrderedIndex     gpaIndex;      /* (value, ID) keys for range queries */
+    OrderedIndex     ageIndex;
+    CourseAggregates courseAgg;     /* running per-course sum/count and top-GPA heaps */
+    SnapshotMapping  mapping;       /* non-empty while students points into a mapped snapshot */
+} Store;
+
+#define COMPACT_MIN_SLOTS 64  /* never bother compacting smaller arrays */
+#define COMPACT_DEAD_RATIO 4  /* compact once over 1/4 of the slots are dead */
+
+/*
+ * Readers never wait for writers (left-right scheme):
+ *  - two identical copies of the store are kept; a reader registers in the
+ *    counter of the copy activeStore names and uses that copy
+ *  - writers take writeLock one at a time, change the idle copy, switch
+ *    readers over to it, wait for the readers still on the old copy to
+ *    finish, then make the same change there
+ *  - changes are journaled and fsync'd before either copy is touched
+ * Everything below works on `store`, the copy the calling thread is
+ * currently reading (readBegin/readEnd) or changing (applyChange).
+ */
+static Store                 stores[2];
+static _Thread_local Store  *store        = NULL;
+static _Thread_local int     readingStore = 0;
+static atomic_int            activeStore;
+static struct {
+    atomic_int count;
+    char       pad[64 - sizeof(atomic_int)];  /* one cache line per counter */
+} readers[2];
+static pthread_mutex_t       writeLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* A change to `store`; applied once per copy, copy 0 first */
+typedef void (*StoreChange)(void *arg, int copy);
+
+static int storeOnline = 0;  /* set once initSystem returns; readers may exist from then on */
+
+static uint64_t loadedLsn = 0;  /* journal LSN covered by the loaded snapshot */
+
+/* Write-ahead journal and the background compaction that folds it into a snapshot */
+static Journal    journal;
+static pthread_t  compactThread;
+static int        compactRunning = 0;
+static atomic_int compactDone;
+
+/* Snapshot sections plus the buffers that back them (NULL when borrowed from the store) */
+typedef struct {
+    SnapshotData   data;
+    StudentRecord *recordsCopy;
+    char          *coursesCopy;
+    char          *namesCopy;
+} SnapshotCapture;
+
+static struct {
+    SnapshotCapture capture;  /* private copy of the store */
+    uint64_t        lsn;      /* journal position the copy reflects */
+    int             ok;
+} compactJob;
 
 /* ===================== Internal Helpers ===================== */
 
-/* Ensure we have enough capacity in the dynamic array */
-static void ensureCapacity(void) {
-    if (studentCount >= capacity) {
-        int newCap = (capacity == 0) ? 2 : capacity * 2;
-        Student *tmp = realloc(students, newCap * sizeof(Student));
+/* Pin the active copy as `store` until readEnd; never waits for a writer */
+static void readBegin(void) {
+    for (;;) {
+        int i = atomic_load(&activeStore);
+        atomic_fetch_add(&readers[i].count, 1);
+        if (atomic_load(&activeStore) == i) {
+            readingStore = i;
+            store = &stores[i];
+            return;
+        }
+        /* A writer switched copies in between; register on the new one */
+        atomic_fetch_sub(&readers[i].count, 1);
+    }
+}
+
+static void readEnd(void) {
+    atomic_fetch_sub(&readers[readingStore].count, 1);
+    store = NULL;
+}
+
+static void waitForReaders(int copy) {
+    while (atomic_load(&readers[copy].count) > 0)
+        sched_yield();
+}
+
+/* Serialize writers; both copies are identical while writeLock is held,
+   so `store` (the active copy) can be read to validate a change */
+static void writeBegin(void) {
+    pthread_mutex_lock(&writeLock);
+    store = &stores[atomic_load(&activeStore)];
+}
+
+static void writeEnd(void) {
+    store = NULL;
+    pthread_mutex_unlock(&writeLock);
+}
+
+/* Apply a change to both copies (caller holds writeLock). Readers keep
+   going on one copy while the other is changed; only the writer waits. */
+static void applyChange(StoreChange change, void *arg) {
+    int next = 1 - atomic_load(&activeStore);
+    waitForReaders(next);  /* readers that lost the race in readBegin */
+    store = &stores[next];
+    change(arg, 0);
+    atomic_store(&activeStore, next);
+    waitForReaders(1 - next);
+    store = &stores[1 - next];
+    change(arg, 1);
+    store = &stores[next];
+}
+
+typedef struct {
+    StoreChange change;
+    void       *arg;
+} ChangeJob;
+
+static void *changeWorker(void *arg) {
+    ChangeJob *job = arg;
+    store = &stores[1];
+    job->change(job->arg, 1);
+    return NULL;
+}
+
+/* Apply a whole-store change (a load). During startup nobody can be
+   reading yet, so both copies are built at once on two threads. */
+static void applyBulkChange(StoreChange change, void *arg) {
+    ChangeJob job = { change, arg };
+    pthread_t worker;
+    if (storeOnline || pthread_create(&worker, NULL, changeWorker, &job) != 0) {
+        applyChange(change, arg);
+        return;
+    }
+    store = &stores[0];
+    change(arg, 0);
+    pthread_join(worker, NULL);
+    atomic_store(&activeStore, 0);
+}
+
+/* Ensure the dynamic array can hold at least `needed` students */
+static void reserveCapacity(int needed) {
+    if (needed > store->capacity) {
+        int newCap = (store->capacity == 0) ? 2 : store->capacity * 2;
+        while (newCap < needed) newCap *= 2;
+        StudentRecord *tmp;
+        if (store->mapping.base) {
+            /* Array lives in a snapshot mapping: move it to the heap */
+            tmp = malloc((size_t)newCap * sizeof(StudentRecord));
+            if (tmp && store->slotCount > 0)
+                memcpy(tmp, store->students, store->slotCount * sizeof(StudentRecord));
+        } else {
+            tmp = realloc(store->students, (size_t)newCap * sizeof(StudentRecord));
+        }
         if (!tmp) {
             printf("Error: memory allocation failed!\n");
             exit(EXIT_FAILURE);
         }
-        students = tmp;
-        capacity = newCap;
+        if (store->mapping.base)
+            snapshotUnmap(&store->mapping);
+        store->students = tmp;
+        store->capacity = newCap;
     }
 }
 
+/* Ensure there is room for one more student */
+static void ensureCapacity(void) {
+    reserveCapacity(store->slotCount + 1);
+}
+
+/* Drop the current array, whether heap-allocated or mapped */
+static void releaseStorage(void) {
+    if (store->mapping.base)
+        snapshotUnmap(&store->mapping);
+    else
+        free(store->students);
+    store->students     = NULL;
+    store->slotCount    = 0;
+    store->studentCount = 0;
+    store->capacity     = 0;
+    store->freeCount    = 0;
+}
+
 /* Calculate GPA based on grades */
 static void calcGPA(Student *s) {
     if (s->numGrades == 0) {
@@ -36,13 +233,134 @@ static void calcGPA(Student *s) {
     s->gpa = sum / s->numGrades;
 }
 
-/* Find student index by ID (linear search) */
+static const char *recordName(const StudentRecord *r) {
+    return strArenaGet(&store->names, r->nameRef);
+}
+
+static const char *recordCourse(const StudentRecord *r) {
+    return strPoolGet(&store->courses, r->courseId);
+}
+
+/* Encode s into the compact record form; nameRef is where s->name is stored */
+static void packStudent(const Student *s, uint32_t nameRef, StudentRecord *r) {
+    r->id        = s->id;
+    r->age       = s->age;
+    r->nameRef   = nameRef;
+    r->courseId  = strPoolIntern(&store->courses, s->course);
+    r->numGrades = s->numGrades;
+    memcpy(r->grades, s->grades, sizeof(r->grades));
+    r->gpa       = s->gpa;
+}
+
+/* Decode a record back into the exchange form */
+static void unpackStudent(const StudentRecord *r, Student *s) {
+    memset(s, 0, sizeof(*s));
+    s->id        = r->id;
+    s->age       = r->age;
+    snprintf(s->name, sizeof(s->name), "%s", recordName(r));
+    snprintf(s->course, sizeof(s->course), "%s", recordCourse(r));
+    s->numGrades = r->numGrades;
+    memcpy(s->grades, r->grades, sizeof(s->grades));
+    s->gpa       = r->gpa;
+}
+
+/* Ordered-index keys: the value in the high 32 bits, the student ID in the low 32 */
+static uint64_t gpaKey(float gpa, int id) {
+    return sortKeyFromFloat(gpa) << 32 | (uint32_t)id;
+}
+
+static uint64_t ageKey(int age, int id) {
+    return sortKeyFromInt(age) << 32 | (uint32_t)id;
+}
+
+static int idFromKey(uint64_t key) {
+    return (int)(uint32_t)key;
+}
+
+/* Is slot i a live record (not a tombstone)? */
+static int slotIsLive(int i) {
+    return store->columns.courseId[i] != DEAD_ROW;
+}
+
+/* Find student index by ID (hash lookup; tombstones are never indexed) */
 static int findStudentIndexById(int id) {
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].id == id)
-            return i;
+    return idIndexGet(&store->idIndex, id);
+}
+
+/* Copy the report fields of students[i] into the columnar mirror */
+static void syncColumnRow(int i) {
+    columnsSetRow(&store->columns, i, store->students[i].gpa, store->students[i].courseId, store->students[i].age);
+}
+
+/* Re-derive the ID index and columns (after anything that reorders students[]);
+   every slot must hold a live record */
+static void rebuildIndexes(void) {
+    idIndexClear(&store->idIndex);
+    idIndexReserve(&store->idIndex, store->slotCount);
+    columnsResize(&store->columns, store->slotCount);
+    for (int i = 0; i < store->slotCount; i++) {
+        idIndexPut(&store->idIndex, store->students[i].id, i);
+        syncColumnRow(i);
+    }
+}
+
+/* Re-derive the per-course aggregates from scratch (after a load) */
+static void rebuildCourseAggregates(void) {
+    courseAggClear(&store->courseAgg);
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        courseAggAdd(&store->courseAgg, store->columns.courseId[i], store->students[i].id, store->students[i].gpa);
     }
-    return -1;
+}
+
+/* Bulk-build one ordered index from the keys of the live records */
+static void buildOrderedIndex(OrderedIndex *ix, int byAge) {
+    SortKey  *keys   = malloc((store->studentCount > 0 ? store->studentCount : 1) * sizeof(SortKey));
+    uint64_t *sorted = malloc((store->studentCount > 0 ? store->studentCount : 1) * sizeof(uint64_t));
+    if (!keys || !sorted) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    int n = 0;
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        keys[n].key   = byAge ? ageKey(store->students[i].age, store->students[i].id)
+                              : gpaKey(store->students[i].gpa, store->students[i].id);
+        keys[n].index = i;
+        n++;
+    }
+    keySort(keys, n);
+    for (int i = 0; i < n; i++) {
+        sorted[i] = keys[i].key;
+    }
+    ordIndexBuild(ix, sorted, n);
+    free(keys);
+    free(sorted);
+}
+
+/* Re-derive the name and range indexes from scratch (after a load) */
+static void rebuildSearchIndexes(void) {
+    nameIndexClear(&store->nameIndex);
+    for (int i = 0; i < store->slotCount; i++) {
+        if (slotIsLive(i))
+            nameIndexAdd(&store->nameIndex, recordName(&store->students[i]), store->students[i].id);
+    }
+    buildOrderedIndex(&store->gpaIndex, 0);
+    buildOrderedIndex(&store->ageIndex, 1);
+}
+
+/* Drop every record together with all derived indexes */
+static void clearStore(void) {
+    releaseStorage();
+    idIndexClear(&store->idIndex);
+    nameIndexClear(&store->nameIndex);
+    ordIndexClear(&store->gpaIndex);
+    ordIndexClear(&store->ageIndex);
+    columnsResize(&store->columns, 0);
+    courseAggClear(&store->courseAgg);
+    strArenaClear(&store->names);
 }
 
 /* Check if ID is unique in the current array */
@@ -50,8 +368,295 @@ static int idIsUnique(int id) {
     return findStudentIndexById(id) == -1;
 }
 
+/* Store a record in a free slot, or append it (caller has checked the ID is unique) */
+static void insertStudent(const Student *s) {
+    int idx;
+    if (store->freeCount > 0) {
+        idx = store->freeSlots[--store->freeCount];
+    } else {
+        ensureCapacity();
+        idx = store->slotCount++;
+        columnsResize(&store->columns, store->slotCount);
+    }
+    idIndexPut(&store->idIndex, s->id, idx);
+    packStudent(s, strArenaAdd(&store->names, s->name), &store->students[idx]);
+    nameIndexAdd(&store->nameIndex, s->name, s->id);
+    ordIndexInsert(&store->gpaIndex, gpaKey(s->gpa, s->id));
+    ordIndexInsert(&store->ageIndex, ageKey(s->age, s->id));
+    store->studentCount++;
+    syncColumnRow(idx);
+    courseAggAdd(&store->courseAgg, store->columns.courseId[idx], s->id, s->gpa);
+}
+
+/* Overwrite the record at idx (same ID) and refresh derived data */
+static void replaceStudentAt(int idx, const Student *s) {
+    courseAggRemove(&store->courseAgg, store->columns.courseId[idx], s->id);
+    const StudentRecord *old = &store->students[idx];
+    if (old->gpa != s->gpa) {
+        ordIndexRemove(&store->gpaIndex, gpaKey(old->gpa, s->id));
+        ordIndexInsert(&store->gpaIndex, gpaKey(s->gpa, s->id));
+    }
+    if (old->age != s->age) {
+        ordIndexRemove(&store->ageIndex, ageKey(old->age, s->id));
+        ordIndexInsert(&store->ageIndex, ageKey(s->age, s->id));
+    }
+
+    /* An unchanged name keeps its arena copy */
+    uint32_t nameRef = store->students[idx].nameRef;
+    if (strcmp(recordName(&store->students[idx]), s->name) != 0) {
+        nameIndexRemove(&store->nameIndex, recordName(&store->students[idx]), s->id);
+        nameIndexAdd(&store->nameIndex, s->name, s->id);
+        nameRef = strArenaAdd(&store->names, s->name);
+    }
+    packStudent(s, nameRef, &store->students[idx]);
+    syncColumnRow(idx);
+    courseAggAdd(&store->courseAgg, store->columns.courseId[idx], s->id, s->gpa);
+}
+
+/* Squeeze out tombstones in place, keeping the order of live records,
+   and repack the name arena without the names they left behind */
+static void compactStore(void) {
+    StringArena packed;
+    strArenaInit(&packed);
+    int live = 0;
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        uint32_t nameRef = strArenaAdd(&packed, recordName(&store->students[i]));
+        if (i != live)
+            store->students[live] = store->students[i];
+        store->students[live].nameRef = nameRef;
+        live++;
+    }
+    strArenaFree(&store->names);
+    store->names     = packed;
+    store->slotCount = live;
+    store->freeCount = 0;
+    rebuildIndexes();
+}
+
+/* Tombstone the record at idx in O(1); compacts when the dead share grows too large */
+static void removeStudentAt(int idx) {
+    courseAggRemove(&store->courseAgg, store->columns.courseId[idx], store->students[idx].id);
+    idIndexRemove(&store->idIndex, store->students[idx].id);
+    nameIndexRemove(&store->nameIndex, recordName(&store->students[idx]), store->students[idx].id);
+    ordIndexRemove(&store->gpaIndex, gpaKey(store->students[idx].gpa, store->students[idx].id));
+    ordIndexRemove(&store->ageIndex, ageKey(store->students[idx].age, store->students[idx].id));
+    columnsKillRow(&store->columns, idx);
+    store->studentCount--;
+
+    if (store->freeCount == store->freeCap) {
+        store->freeCap = (store->freeCap == 0) ? 16 : store->freeCap * 2;
+        int *tmp = realloc(store->freeSlots, (size_t)store->freeCap * sizeof(int));
+        if (!tmp) {
+            printf("Error: memory allocation failed!\n");
+            exit(EXIT_FAILURE);
+        }
+        store->freeSlots = tmp;
+    }
+    store->freeSlots[store->freeCount++] = idx;
+
+    if (store->slotCount >= COMPACT_MIN_SLOTS && store->freeCount * COMPACT_DEAD_RATIO > store->slotCount)
+        compactStore();
+}
+
+static void releaseCapture(SnapshotCapture *c) {
+    free(c->recordsCopy);
+    free(c->coursesCopy);
+    free(c->namesCopy);
+    memset(c, 0, sizeof(*c));
+}
+
+/*
+ * Describe the store as snapshot sections (caller holds writeLock).
+ * Tombstones are never written, so the records are packed into a copy if
+ * any exist. With copyAll every section is copied and the capture stays
+ * valid after the lock is released. Returns 0, or -1 if out of memory.
+ */
+static int captureSnapshot(SnapshotCapture *c, int copyAll) {
+    memset(c, 0, sizeof(*c));
+    SnapshotData *d = &c->data;
+
+    size_t courseBytes = 0;
+    for (int id = 0; id < store->courses.count; id++)
+        courseBytes += strlen(strPoolGet(&store->courses, id)) + 1;
+    c->coursesCopy = malloc(courseBytes > 0 ? courseBytes : 1);
+    if (!c->coursesCopy)
+        return -1;
+    char *p = c->coursesCopy;
+    for (int id = 0; id < store->courses.count; id++) {
+        size_t len = strlen(strPoolGet(&store->courses, id)) + 1;
+        memcpy(p, strPoolGet(&store->courses, id), len);
+        p += len;
+    }
+    d->courses     = c->coursesCopy;
+    d->courseBytes = courseBytes;
+    d->courseCount = store->courses.count;
+
+    d->count = store->studentCount;
+    if (copyAll || store->freeCount > 0) {
+        c->recordsCopy = malloc((store->studentCount > 0 ? store->studentCount : 1) * sizeof(StudentRecord));
+        if (!c->recordsCopy) {
+            releaseCapture(c);
+            return -1;
+        }
+        int n = 0;
+        for (int i = 0; i < store->slotCount; i++) {
+            if (slotIsLive(i))
+                c->recordsCopy[n++] = store->students[i];
+        }
+        d->records = c->recordsCopy;
+    } else {
+        d->records = store->students;
+    }
+
+    d->nameBytes = store->names.used;
+    if (copyAll) {
+        c->namesCopy = malloc(store->names.used > 0 ? store->names.used : 1);
+        if (!c->namesCopy) {
+            releaseCapture(c);
+            return -1;
+        }
+        if (store->names.used > 0)
+            memcpy(c->namesCopy, store->names.data, store->names.used);
+        d->names = c->namesCopy;
+    } else {
+        d->names = store->names.data;
+    }
+    return 0;
+}
+
+/* ===================== Journal & Compaction ===================== */
+
+/* Apply one add/update/delete to `store`; records that no longer fit the
+   current state (an add of an existing ID, ...) are skipped */
+static void applyRecord(JournalOp op, const Student *s) {
+    int idx = findStudentIndexById(s->id);
+    switch (op) {
+        case JOURNAL_ADD:
+            if (idx == -1) insertStudent(s);
+            break;
+        case JOURNAL_UPDATE:
+            if (idx != -1) replaceStudentAt(idx, s);
+            break;
+        case JOURNAL_DELETE:
+            if (idx != -1) removeStudentAt(idx);
+            break;
+    }
+}
+
+typedef struct {
+    JournalOp      op;
+    const Student *student;
+} RecordChange;
+
+static void changeRecord(void *arg, int copy) {
+    (void)copy;
+    const RecordChange *c = arg;
+    applyRecord(c->op, c->student);
+}
+
+/* Re-apply one journal record on top of the loaded snapshot (writeLock is held) */
+static void replayJournalRecord(JournalOp op, const Student *s) {
+    RecordChange c = { op, s };
+    applyChange(changeRecord, &c);
+}
+
+static void *compactWorker(void *arg) {
+    (void)arg;
+    compactJob.ok = snapshotWrite(SNAPSHOT_FILE, &compactJob.capture.data,
+                                  compactJob.lsn) == 0;
+    atomic_store(&compactDone, 1);
+    return NULL;
+}
+
+/* Reap a finished compaction (or wait for a running one) and trim the journal */
+static void finishCompaction(int wait) {
+    if (!compactRunning)
+        return;
+    if (!wait && !atomic_load(&compactDone))
+        return;
+    pthread_join(compactThread, NULL);
+    compactRunning = 0;
+    releaseCapture(&compactJob.capture);
+    if (compactJob.ok)
+        journalTrim(&journal, compactJob.lsn);
+}
+
+/* Start a background snapshot once the journal passes the size threshold.
+   Call with writeLock held after a logged change, so the copy matches lastLsn. */
+static void maybeCompact(void) {
+    finishCompaction(0);
+    if (compactRunning || journal.size < JOURNAL_COMPACT_BYTES)
+        return;
+
+    if (captureSnapshot(&compactJob.capture, 1) != 0)
+        return;  /* try again after the next change */
+
+    compactJob.lsn = journal.lastLsn;
+    compactJob.ok  = 0;
+    atomic_store(&compactDone, 0);
+    if (pthread_create(&compactThread, NULL, compactWorker, NULL) != 0) {
+        releaseCapture(&compactJob.capture);
+        return;
+    }
+    compactRunning = 1;
+}
+
+/* Durably log a change, then apply it to both copies (caller holds writeLock) */
+static StoreStatus commitChange(JournalOp op, const Student *s) {
+    if (journalAppend(&journal, op, s) != 0)
+        return STORE_IO_ERROR;
+    RecordChange c = { op, s };
+    applyChange(changeRecord, &c);
+    maybeCompact();
+    return STORE_OK;
+}
+
 /* ===================== File Handling ===================== */
 
+typedef struct {
+    const Student *records;
+    int            count;
+    int            added;
+} StudentBatch;
+
+/* Insert a batch, skipping IDs already present (or seen earlier in the batch) */
+static void changeAddBatch(void *arg, int copy) {
+    (void)copy;
+    StudentBatch *b = arg;
+    reserveCapacity(store->slotCount + b->count);
+    idIndexReserve(&store->idIndex, store->studentCount + b->count);
+    int added = 0;
+    for (int i = 0; i < b->count; i++) {
+        if (!idIsUnique(b->records[i].id))
+            continue;
+        insertStudent(&b->records[i]);
+        added++;
+    }
+    if (copy == 0)
+        b->added = added;  /* the same for both copies */
+}
+
+/* Replace the store with a batch of distinct IDs: pack the records, then
+   build every index in one pass (cheaper than inserting one by one) */
+static void changeLoadRecords(void *arg, int copy) {
+    StudentBatch *b = arg;
+    clearStore();
+    reserveCapacity(b->count);
+    for (int i = 0; i < b->count; i++) {
+        const Student *s = &b->records[i];
+        packStudent(s, strArenaAdd(&store->names, s->name), &store->students[i]);
+    }
+    store->slotCount    = b->count;
+    store->studentCount = b->count;
+    rebuildIndexes();
+    rebuildCourseAggregates();
+    rebuildSearchIndexes();
+    if (copy == 0)
+        b->added = b->count;
+}
+
 void saveToFile(const char *filename) {
     FILE *fp = fopen(filename, "w");
     if (!fp) {
@@ -59,88 +664,232 @@ void saveToFile(const char *filename) {
         return;
     }
 
+    readBegin();
+
     /* First line: number of students */
-    fprintf(fp, "%d\n", studentCount);
+    fprintf(fp, "%d\n", store->studentCount);
 
-    for (int i = 0; i < studentCount; i++) {
-        Student *s = &students[i];
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        const StudentRecord *s = &store->students[i];
         fprintf(fp, "%d %s %d %s %d",
-                s->id, s->name, s->age, s->course, s->numGrades);
+                s->id, recordName(s), s->age, recordCourse(s), s->numGrades);
         for (int j = 0; j < s->numGrades; j++) {
             fprintf(fp, " %.2f", s->grades[j]);
         }
         fprintf(fp, "\n");
     }
 
+    readEnd();
     fclose(fp);
     printf("Data saved to '%s'.\n", filename);
 }
 
 void loadFromFile(const char *filename) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
+    if (access(filename, F_OK) != 0) {
         printf("No existing data file found ('%s'). Starting fresh.\n", filename);
         return;
     }
 
-    int count;
-    if (fscanf(fp, "%d", &count) != 1 || count < 0) {
-        printf("Error: invalid data format in file.\n");
-        fclose(fp);
+    /* Parsed on all cores; the header count pre-sizes the buffers */
+    BulkResult r;
+    if (bulkParseFile(filename, bulkParseTextLine, BULK_HEADER_COUNT, &r) != 0)
         return;
+
+    /* First record wins on duplicate IDs */
+    IdIndex seen;
+    idIndexInit(&seen);
+    idIndexReserve(&seen, r.count);
+    int kept = 0;
+    for (int i = 0; i < r.count; i++) {
+        if (idIndexGet(&seen, r.records[i].id) != -1) {
+            printf("Warning: duplicate student ID %d skipped.\n", r.records[i].id);
+            continue;
+        }
+        idIndexPut(&seen, r.records[i].id, kept);
+        calcGPA(&r.records[i]);
+        r.records[kept++] = r.records[i];
     }
+    idIndexFree(&seen);
+
+    StudentBatch b = { r.records, kept, 0 };
+    writeBegin();
+    applyBulkChange(changeLoadRecords, &b);
+    writeEnd();
+    bulkResultFree(&r);
+    printf("Loaded %d student(s) from '%s'.\n", b.added, filename);
+}
 
-    /* Clear current data */
-    free(students);
-    students = NULL;
-    studentCount = 0;
-    capacity = 0;
+void saveSnapshot(const char *filename) {
+    /* writeLock pins the journal position; readers carry on meanwhile */
+    writeBegin();
+    finishCompaction(1);
+    SnapshotCapture c;
+    int rc = captureSnapshot(&c, 0);
+    if (rc == 0)
+        rc = snapshotWrite(filename, &c.data, journal.lastLsn);
+    else
+        printf("Error: memory allocation failed!\n");
+    releaseCapture(&c);
+    /* The store snapshot now covers the whole journal */
+    if (rc == 0 && strcmp(filename, SNAPSHOT_FILE) == 0 && journal.fd >= 0)
+        journalTrim(&journal, journal.lastLsn);
+    writeEnd();
+    if (rc != 0)
+        return;
+    printf("Data saved to '%s'.\n", filename);
+}
 
-    for (int i = 0; i < count; i++) {
-        Student s;
-        if (fscanf(fp, "%d %49s %d %49s %d",
-                   &s.id, s.name, &s.age, s.course, &s.numGrades) != 5) {
-            printf("Error: invalid student record format.\n");
-            break;
-        }
+/* Every record must point inside the snapshot's course dictionary and name arena,
+   and hold at most MAX_SUBJECTS grades */
+static int snapshotRecordsValid(const SnapshotData *d) {
+    for (int i = 0; i < d->count; i++) {
+        if (d->records[i].courseId < 0 || d->records[i].courseId >= d->courseCount ||
+            d->records[i].nameRef >= d->nameBytes ||
+            d->records[i].numGrades < 0 || d->records[i].numGrades > MAX_SUBJECTS)
+            return 0;
+    }
+    return 1;
+}
 
-        if (s.numGrades < 0) s.numGrades = 0;
-        if (s.numGrades > MAX_SUBJECTS) s.numGrades = MAX_SUBJECTS;
+/* Make this copy's mapping (arg is SnapshotMapping[2]) the whole store */
+static void changeLoadSnapshot(void *arg, int copy) {
+    SnapshotMapping *m = &((SnapshotMapping *)arg)[copy];
+    SnapshotData    *d = &m->data;
 
-        for (int j = 0; j < s.numGrades; j++) {
-            if (fscanf(fp, "%f", &s.grades[j]) != 1) {
-                s.grades[j] = 0.0f;
-            }
-        }
+    int *courseMap = malloc((d->courseCount > 0 ? d->courseCount : 1) * sizeof(int));
+    if (!courseMap) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
 
-        calcGPA(&s);
-        ensureCapacity();
-        students[studentCount++] = s;
+    clearStore();
+    strArenaAssign(&store->names, d->names, d->nameBytes);
+
+    /* Course ids in the file follow its dictionary; translate any that differ here */
+    int remap = 0;
+    const char *name = d->courses;
+    for (int k = 0; k < d->courseCount; k++) {
+        courseMap[k] = strPoolIntern(&store->courses, name);
+        remap |= courseMap[k] != k;
+        name += strlen(name) + 1;
+    }
+    for (int i = 0; remap && i < d->count; i++) {
+        d->records[i].courseId = courseMap[d->records[i].courseId];
     }
+    free(courseMap);
 
-    fclose(fp);
-    printf("Loaded %d student(s) from '%s'.\n", studentCount, filename);
+    if (d->count == 0) {
+        snapshotUnmap(m);
+    } else {
+        /* Use the mapped records in place; copied to the heap on first growth */
+        store->mapping      = *m;
+        store->students     = d->records;
+        store->slotCount    = d->count;
+        store->studentCount = d->count;
+        store->capacity     = d->count;
+    }
+    rebuildIndexes();
+    rebuildCourseAggregates();
+    rebuildSearchIndexes();
+}
+
+int loadSnapshot(const char *filename) {
+    /* Each copy maps the file privately; pages neither copy writes to
+       stay shared in the page cache */
+    SnapshotMapping maps[2];
+    for (int k = 0; k < 2; k++) {
+        int rc = snapshotMap(filename, &maps[k]);
+        if (rc == 0 && !snapshotRecordsValid(&maps[k].data)) {
+            snapshotUnmap(&maps[k]);
+            rc = -1;
+        }
+        if (rc != 0) {
+            if (k == 1)
+                snapshotUnmap(&maps[0]);
+            if (rc < 0)
+                printf("Error: snapshot '%s' is corrupt or truncated; ignoring it.\n", filename);
+            return -1;
+        }
+    }
+
+    writeBegin();
+    applyBulkChange(changeLoadSnapshot, maps);
+    loadedLsn = maps[0].lsn;
+    int count = store->studentCount;
+    writeEnd();
+    printf("Loaded %d student(s) from '%s'.\n", count, filename);
+    return 0;
 }
 
 /* ===================== Init / Cleanup ===================== */
 
+static void initStoreCopy(void) {
+    memset(store, 0, sizeof(*store));
+    idIndexInit(&store->idIndex);
+    nameIndexInit(&store->nameIndex);
+    ordIndexInit(&store->gpaIndex);
+    ordIndexInit(&store->ageIndex);
+    strPoolInit(&store->courses);
+    strArenaInit(&store->names);
+    columnsInit(&store->columns);
+    courseAggInit(&store->courseAgg);
+}
+
+static void freeStoreCopy(void) {
+    releaseStorage();
+    free(store->freeSlots);
+    store->freeSlots = NULL;
+    store->freeCap   = 0;
+    idIndexFree(&store->idIndex);
+    nameIndexFree(&store->nameIndex);
+    ordIndexFree(&store->gpaIndex);
+    ordIndexFree(&store->ageIndex);
+    columnsFree(&store->columns);
+    courseAggFree(&store->courseAgg);
+    strPoolFree(&store->courses);
+    strArenaFree(&store->names);
+}
+
 void initSystem(void) {
-    students     = NULL;
-    studentCount = 0;
-    capacity     = 0;
-    loadFromFile(DATA_FILE);
+    for (int k = 0; k < 2; k++) {
+        store = &stores[k];
+        initStoreCopy();
+    }
+    store = NULL;
+    atomic_store(&activeStore, 0);
+    journal.fd = -1;
+    /* Prefer the binary snapshot; fall back to importing the text file */
+    if (loadSnapshot(SNAPSHOT_FILE) != 0)
+        loadFromFile(DATA_FILE);
+
+    /* Replay changes made since the snapshot was written */
+    writeBegin();
+    int replayed = journalOpen(&journal, JOURNAL_FILE, loadedLsn, replayJournalRecord);
+    writeEnd();
+    if (replayed > 0)
+        printf("Replayed %d change(s) from '%s'.\n", replayed, JOURNAL_FILE);
+    storeOnline = 1;
 }
 
 void cleanupSystem(void) {
-    free(students);
-    students     = NULL;
-    studentCount = 0;
-    capacity     = 0;
+    finishCompaction(1);
+    /* Fold outstanding changes so the next start is a plain snapshot map */
+    if (journal.size > 0)
+        saveSnapshot(SNAPSHOT_FILE);
+    journalClose(&journal);
+    for (int k = 0; k < 2; k++) {
+        store = &stores[k];
+        freeStoreCopy();
+    }
+    store = NULL;
+    storeOnline = 0;
 }
 
 /* ===================== CRUD Operations ===================== */
 
-static void displayStudent(const Student *s) {
+static void printStudent(const Student *s) {
     printf("ID: %d | Name: %s | Age: %d | Course: %s | GPA: %.2f\n",
            s->id, s->name, s->age, s->course, s->gpa);
     printf("  Grades: ");
@@ -150,8 +899,33 @@ static void displayStudent(const Student *s) {
     printf("\n");
 }
 
+static void displayStudent(const StudentRecord *r) {
+    Student s;
+    unpackStudent(r, &s);
+    printStudent(&s);
+}
+
+/* Tell the user why a change was refused; returns 1 unless rc is STORE_OK */
+static int reportFailure(StoreStatus rc) {
+    switch (rc) {
+        case STORE_OK:
+            return 0;
+        case STORE_NOT_FOUND:
+            printf("Student not found.\n");
+            break;
+        case STORE_DUPLICATE:
+            printf("Error: student ID must be unique.\n");
+            break;
+        case STORE_IO_ERROR:
+            printf("Error: change could not be saved; nothing was modified.\n");
+            break;
+    }
+    return 1;
+}
+
 void addStudent(void) {
     Student s;
+    memset(&s, 0, sizeof(s));  /* records are written to disk byte-for-byte */
 
     printf("Enter student ID: ");
     if (scanf("%d", &s.id) != 1) {
@@ -159,7 +933,10 @@ void addStudent(void) {
         return;
     }
 
-    if (!idIsUnique(s.id)) {
+    readBegin();
+    int unique = idIsUnique(s.id);
+    readEnd();
+    if (!unique) {
         printf("Error: student ID must be unique.\n");
         return;
     }
@@ -195,22 +972,25 @@ void addStudent(void) {
         s.grades[i] = g;
     }
 
-    calcGPA(&s);
-    ensureCapacity();
-    students[studentCount++] = s;
+    /* The ID is checked again under the write lock in case it was taken meanwhile */
+    if (reportFailure(storeInsertStudent(&s)))
+        return;
     printf("Student added successfully.\n");
-    saveToFile(DATA_FILE);
 }
 
 void displayAllStudents(void) {
-    if (studentCount == 0) {
+    readBegin();
+    if (store->studentCount == 0) {
         printf("No student records.\n");
-        return;
     }
-    for (int i = 0; i < studentCount; i++) {
-        printf("---- Student %d ----\n", i + 1);
-        displayStudent(&students[i]);
+    int shown = 0;
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        printf("---- Student %d ----\n", ++shown);
+        displayStudent(&store->students[i]);
     }
+    readEnd();
 }
 
 void updateStudent(void) {
@@ -218,15 +998,21 @@ void updateStudent(void) {
     printf("Enter ID of student to update: ");
     scanf("%d", &id);
 
+    /* Edit a copy; it replaces the record only once journaled */
+    Student updated;
+    readBegin();
     int idx = findStudentIndexById(id);
+    if (idx != -1) {
+        unpackStudent(&store->students[idx], &updated);
+        printf("Updating student:\n");
+        displayStudent(&store->students[idx]);
+    }
+    readEnd();
     if (idx == -1) {
         printf("Student not found.\n");
         return;
     }
-
-    Student *s = &students[idx];
-    printf("Updating student:\n");
-    displayStudent(s);
+    Student *s = &updated;
 
     printf("Enter new name (or . to keep '%s'): ", s->name);
     char newName[MAX_NAME];
@@ -254,10 +1040,12 @@ void updateStudent(void) {
     scanf("%d", &changeGrades);
     if (changeGrades == 1) {
         printf("Enter number of subjects (1-%d): ", MAX_SUBJECTS);
-        scanf("%d", &s->numGrades);
-        if (s->numGrades <= 0 || s->numGrades > MAX_SUBJECTS) {
+        int numGrades;
+        scanf("%d", &numGrades);
+        if (numGrades <= 0 || numGrades > MAX_SUBJECTS) {
             printf("Invalid number of subjects. Keeping old grades.\n");
         } else {
+            s->numGrades = numGrades;
             for (int i = 0; i < s->numGrades; i++) {
                 float g;
                 printf("Enter grade %d (0-100): ", i + 1);
@@ -271,9 +1059,9 @@ void updateStudent(void) {
         }
     }
 
-    calcGPA(s);
+    if (reportFailure(storeUpdateStudent(s)))
+        return;
     printf("Student updated.\n");
-    saveToFile(DATA_FILE);
 }
 
 void deleteStudent(void) {
@@ -281,18 +1069,322 @@ void deleteStudent(void) {
     printf("Enter ID of student to delete: ");
     scanf("%d", &id);
 
-    int idx = findStudentIndexById(id);
-    if (idx == -1) {
-        printf("Student not found.\n");
+    if (reportFailure(storeRemoveStudent(id)))
         return;
+    printf("Student deleted.\n");
+}
+
+/* ===================== Store Library API ===================== */
+
+StoreStatus storeInsertStudent(Student *s) {
+    calcGPA(s);
+    writeBegin();
+    StoreStatus rc = idIsUnique(s->id) ? commitChange(JOURNAL_ADD, s) : STORE_DUPLICATE;
+    writeEnd();
+    return rc;
+}
+
+StoreStatus storeUpdateStudent(Student *s) {
+    calcGPA(s);
+    writeBegin();
+    StoreStatus rc = (findStudentIndexById(s->id) != -1) ? commitChange(JOURNAL_UPDATE, s)
+                                                         : STORE_NOT_FOUND;
+    writeEnd();
+    return rc;
+}
+
+StoreStatus storeRemoveStudent(int id) {
+    StoreStatus rc = STORE_NOT_FOUND;
+    writeBegin();
+    int idx = findStudentIndexById(id);
+    if (idx != -1) {
+        Student victim;
+        unpackStudent(&store->students[idx], &victim);
+        rc = commitChange(JOURNAL_DELETE, &victim);
     }
+    writeEnd();
+    return rc;
+}
 
-    for (int i = idx; i < studentCount - 1; i++) {
-        students[i] = students[i + 1];
+int storeGetStudent(int id, Student *out) {
+    readBegin();
+    int idx = findStudentIndexById(id);
+    if (idx != -1)
+        unpackStudent(&store->students[idx], out);
+    readEnd();
+    return (idx == -1) ? -1 : 0;
+}
+
+int storeAddStudents(Student *records, int count) {
+    for (int i = 0; i < count; i++) {
+        calcGPA(&records[i]);
     }
-    studentCount--;
-    printf("Student deleted.\n");
-    saveToFile(DATA_FILE);
+    StudentBatch b = { records, count, 0 };
+    writeBegin();
+    applyChange(changeAddBatch, &b);
+    writeEnd();
+    return b.added;
+}
+
+int storeDeleteStudent(int id) {
+    Student victim;
+    memset(&victim, 0, sizeof(victim));
+    victim.id = id;
+    writeBegin();
+    int found = findStudentIndexById(id) != -1;
+    if (found) {
+        RecordChange c = { JOURNAL_DELETE, &victim };
+        applyChange(changeRecord, &c);
+    }
+    writeEnd();
+    return found ? 0 : -1;
+}
+
+/* Index and key interval for a range query; returns 0 if the range is empty */
+static int rangeKeys(RangeField field, float lo, float hi, const OrderedIndex **ix,
+                     uint64_t *loKey, uint64_t *hiKey) {
+    if (!(lo <= hi))
+        return 0;
+    if (field == RANGE_BY_GPA) {
+        *ix    = &store->gpaIndex;
+        *loKey = gpaKey(lo, 0);
+        *hiKey = gpaKey(hi, -1);  /* -1 fills the ID bits with ones */
+        return 1;
+    }
+    /* Ages are whole numbers: round the bounds inwards (clamp, truncate,
+       then step past a fractional part; no libm needed). Compared in
+       double: (float)INT_MAX rounds up to 2^31. */
+    double l = lo, h = hi;
+    if (h < INT_MIN || l > INT_MAX)
+        return 0;
+    if (l < INT_MIN) l = INT_MIN;
+    if (h > INT_MAX) h = INT_MAX;
+    long long a = (long long)l, b = (long long)h;
+    if (a < l) a++;
+    if (b > h) b--;
+    if (a > b)
+        return 0;
+    *ix    = &store->ageIndex;
+    *loKey = ageKey((int)a, 0);
+    *hiKey = ageKey((int)b, -1);
+    return 1;
+}
+
+/* Slots of up to max students in the range, ascending; returns the total in range */
+static int rangeSlots(RangeField field, float lo, float hi, int *slots, int max) {
+    const OrderedIndex *ix;
+    uint64_t loKey, hiKey;
+    if (!rangeKeys(field, lo, hi, &ix, &loKey, &hiKey))
+        return 0;
+    uint64_t *keys = malloc((max > 0 ? max : 1) * sizeof(uint64_t));
+    if (!keys) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    int total = ordIndexRange(ix, loKey, hiKey, keys, max);
+    int shown = (total < max) ? total : max;
+    for (int i = 0; i < shown; i++) {
+        slots[i] = findStudentIndexById(idFromKey(keys[i]));
+    }
+    free(keys);
+    return total;
+}
+
+int storeCountRange(RangeField field, float lo, float hi) {
+    const OrderedIndex *ix;
+    uint64_t loKey, hiKey;
+    readBegin();
+    int n = rangeKeys(field, lo, hi, &ix, &loKey, &hiKey) ? ordIndexCount(ix, loKey, hiKey) : 0;
+    readEnd();
+    return n;
+}
+
+int storeRangeQuery(RangeField field, float lo, float hi, Student *out, int max) {
+    int *slots = malloc((max > 0 ? max : 1) * sizeof(int));
+    if (!slots) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    readBegin();
+    int total = rangeSlots(field, lo, hi, slots, max);
+    int shown = (total < max) ? total : max;
+    for (int i = 0; i < shown; i++) {
+        unpackStudent(&store->students[slots[i]], &out[i]);
+    }
+    readEnd();
+    free(slots);
+    return total;
+}
+
+/* IDs of up to max students matching a name search; returns the total */
+static int nameMatches(NameSearchMode mode, const char *name, int maxDist,
+                       int *ids, int *dist, int max) {
+    switch (mode) {
+        case NAME_EXACT:
+            return nameIndexExact(&store->nameIndex, name, ids, max);
+        case NAME_PREFIX:
+            return nameIndexPrefix(&store->nameIndex, name, ids, max);
+        case NAME_FUZZY:
+            return nameIndexFuzzy(&store->nameIndex, name, maxDist, ids, dist, max);
+    }
+    return 0;
+}
+
+int storeFindByName(NameSearchMode mode, const char *name, int maxDist,
+                    Student *out, int *dist, int max) {
+    int *ids   = malloc((max > 0 ? max : 1) * sizeof(int));
+    int *dists = malloc((max > 0 ? max : 1) * sizeof(int));
+    if (!ids || !dists) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    readBegin();
+    int total = nameMatches(mode, name, maxDist, ids, dists, max);
+    int shown = (total < max) ? total : max;
+    for (int i = 0; i < shown; i++) {
+        unpackStudent(&store->students[findStudentIndexById(ids[i])], &out[i]);
+        if (dist)
+            dist[i] = (mode == NAME_FUZZY) ? dists[i] : 0;
+    }
+    readEnd();
+    free(ids);
+    free(dists);
+    return total;
+}
+
+/* Column selector for a course name, or every course if course is NULL;
+   returns 0 if no student ever took that course */
+static int selectCourse(const char *course, int *courseId) {
+    *courseId = course ? strPoolFind(&store->courses, course) : ALL_COURSES;
+    return !course || *courseId != -1;
+}
+
+int storeStats(const char *course, StoreStats *out) {
+    memset(out, 0, sizeof(*out));
+    readBegin();
+    int courseId;
+    ColumnAggregate agg;
+    if (selectCourse(course, &courseId)) {
+        columnsAggregate(&store->columns, courseId, &agg);
+        out->count = agg.count;
+    }
+    readEnd();
+    if (out->count > 0) {
+        out->avgGpa = (float)(agg.gpaSum / agg.count);
+        out->minGpa = agg.minGpa;
+        out->maxGpa = agg.maxGpa;
+        out->avgAge = (float)(agg.ageSum / agg.count);
+    }
+    return out->count;
+}
+
+int storeTopStudents(const char *course, int n, Student *out) {
+    if (n <= 0)
+        return 0;
+    int *rows = malloc(n * sizeof(int));
+    if (!rows) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    readBegin();
+    int courseId, found = 0;
+    if (selectCourse(course, &courseId)) {
+        found = topNSelect(store->columns.gpa, store->columns.courseId, store->slotCount,
+                           courseId, n, rows);
+    }
+    for (int i = 0; i < found; i++) {
+        unpackStudent(&store->students[rows[i]], &out[i]);
+    }
+    readEnd();
+    free(rows);
+    return found;
+}
+
+int storeGpaPercentiles(const char *course, const double *percents, int count, float *out) {
+    readBegin();
+    int courseId, n = 0;
+    float *gpas = malloc((store->studentCount > 0 ? store->studentCount : 1) * sizeof(float));
+    if (gpas && selectCourse(course, &courseId))
+        n = columnsCopyGpa(&store->columns, courseId, gpas);
+    readEnd();
+    if (!gpas) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    /* Selection on the scratch copy: linear time, the columns stay untouched */
+    if (n > 0)
+        statsPercentiles(gpas, n, percents, count, out);
+    free(gpas);
+    return n;
+}
+
+int storeGpaHistogram(int *counts) {
+    readBegin();
+    int n = store->studentCount;
+    float *gpas = malloc((n > 0 ? n : 1) * sizeof(float));
+    if (gpas)
+        columnsCopyGpa(&store->columns, ALL_COURSES, gpas);
+    readEnd();
+    if (!gpas) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    statsHistogram(gpas, n, counts);
+    free(gpas);
+    return n;
+}
+
+/* Fill out for one course id; returns 0 if the course has no students */
+static int summarizeCourse(int courseId, CourseSummary *out) {
+    const CourseStats *cs = courseAggGet(&store->courseAgg, courseId);
+    int topId;
+    if (!cs || !courseAggTop(&store->courseAgg, courseId, &topId))
+        return 0;
+    snprintf(out->course, MAX_COURSE, "%s", strPoolGet(&store->courses, courseId));
+    out->count  = cs->count;
+    out->avgGpa = (float)(cs->gpaSum / cs->count);
+    unpackStudent(&store->students[findStudentIndexById(topId)], &out->top);
+    return 1;
+}
+
+int storeCourseSummary(const char *course, CourseSummary *out) {
+    memset(out, 0, sizeof(*out));
+    readBegin();
+    summarizeCourse(strPoolFind(&store->courses, course), out);
+    readEnd();
+    return out->count;
+}
+
+int storeAllCourses(CourseSummary *out, int max) {
+    int total = 0;
+    CourseSummary scratch;
+    readBegin();
+    for (int c = 0; c < store->courses.count; c++) {
+        if (summarizeCourse(c, (total < max) ? &out[total] : &scratch))
+            total++;
+    }
+    readEnd();
+    return total;
+}
+
+static void changeCompact(void *arg, int copy) {
+    (void)arg;
+    (void)copy;
+    compactStore();
+}
+
+int storeCompact(void) {
+    writeBegin();
+    int reclaimed = store->freeCount;
+    if (reclaimed > 0)
+        applyChange(changeCompact, NULL);
+    writeEnd();
+    return reclaimed;
+}
+
+void compactStorage(void) {
+    int reclaimed = storeCompact();
+    printf("Compacted storage: %d deleted slot(s) reclaimed.\n", reclaimed);
 }
 
 /* ===================== Search & Sort ===================== */
@@ -302,69 +1394,200 @@ static void searchById(void) {
     printf("Enter ID to search: ");
     scanf("%d", &id);
 
+    readBegin();
     int idx = findStudentIndexById(id);
     if (idx == -1) {
         printf("Student not found.\n");
     } else {
-        displayStudent(&students[idx]);
+        displayStudent(&store->students[idx]);
     }
+    readEnd();
 }
 
-static void searchByName(void) {
+/* Name and range searches list at most SEARCH_LIST_LIMIT matches */
+#define SEARCH_LIST_LIMIT 50
+
+static void searchNames(NameSearchMode mode) {
     char name[MAX_NAME];
-    printf("Enter name to search (exact match): ");
-    scanf("%s", name);
-
-    int found = 0;
-    for (int i = 0; i < studentCount; i++) {
-        if (strcmp(students[i].name, name) == 0) {
-            displayStudent(&students[i]);
-            found = 1;
+    int  maxDist = 0;
+    switch (mode) {
+        case NAME_EXACT:  printf("Enter name to search (exact, any case): "); break;
+        case NAME_PREFIX: printf("Enter the start of the name: "); break;
+        case NAME_FUZZY:  printf("Enter name to search (typos allowed): "); break;
+    }
+    scanf("%49s", name);
+    if (mode == NAME_FUZZY) {
+        printf("Maximum typos (1-2): ");
+        scanf("%d", &maxDist);
+        if (maxDist < 1 || maxDist > 2) {
+            printf("Invalid number of typos.\n");
+            return;
         }
     }
-    if (!found) {
+
+    int ids[SEARCH_LIST_LIMIT], dist[SEARCH_LIST_LIMIT];
+    readBegin();
+    int total = nameMatches(mode, name, maxDist, ids, dist, SEARCH_LIST_LIMIT);
+    int shown = (total < SEARCH_LIST_LIMIT) ? total : SEARCH_LIST_LIMIT;
+    for (int i = 0; i < shown; i++) {
+        if (mode == NAME_FUZZY)
+            printf("[%d typo(s)] ", dist[i]);
+        displayStudent(&store->students[findStudentIndexById(ids[i])]);
+    }
+    readEnd();
+
+    if (total == 0) {
         printf("No students found with that name.\n");
+    } else if (total > shown) {
+        printf("... %d more match(es) not shown; refine the search.\n", total - shown);
     }
 }
 
-/* Simple Bubble Sorts for different keys */
+static void searchByName(void) {
+    searchNames(NAME_EXACT);
+}
 
-static void sortByGPA(void) {
-    for (int i = 0; i < studentCount - 1; i++) {
-        for (int j = 0; j < studentCount - i - 1; j++) {
-            if (students[j].gpa < students[j + 1].gpa) { /* descending */
-                Student temp = students[j];
-                students[j] = students[j + 1];
-                students[j + 1] = temp;
-            }
+static void searchByNamePrefix(void) {
+    searchNames(NAME_PREFIX);
+}
+
+static void searchByNameFuzzy(void) {
+    searchNames(NAME_FUZZY);
+}
+
+/* List the students whose GPA or age lies in a range, straight from the ordered index */
+static void searchRange(RangeField field) {
+    const char *what = (field == RANGE_BY_GPA) ? "GPA" : "age";
+    float lo, hi;
+    printf("Enter lowest %s: ", what);
+    if (scanf("%f", &lo) != 1) {
+        printf("Invalid input.\n");
+        return;
+    }
+    printf("Enter highest %s: ", what);
+    if (scanf("%f", &hi) != 1 || hi < lo) {
+        printf("Invalid range.\n");
+        return;
+    }
+
+    int slots[SEARCH_LIST_LIMIT];
+    readBegin();
+    int total = rangeSlots(field, lo, hi, slots, SEARCH_LIST_LIMIT);
+    int shown = (total < SEARCH_LIST_LIMIT) ? total : SEARCH_LIST_LIMIT;
+    printf("%d student(s) with %s between %.2f and %.2f.\n", total, what, lo, hi);
+    for (int i = 0; i < shown; i++) {
+        displayStudent(&store->students[slots[i]]);
+    }
+    readEnd();
+    if (total > shown) {
+        printf("... %d more match(es) not shown; narrow the range.\n", total - shown);
+    }
+}
+
+static void searchByGpaRange(void) {
+    searchRange(RANGE_BY_GPA);
+}
+
+static void searchByAgeRange(void) {
+    searchRange(RANGE_BY_AGE);
+}
+
+/* Sorting: build (key, index) pairs, radix sort them, apply the permutation once */
+
+/* Names longer than the 8-byte key prefix are resolved with strcmp */
+static int compareNames(const void *ctx, int a, int b) {
+    const StudentRecord *arr = ctx;
+    return strcmp(recordName(&arr[a]), recordName(&arr[b]));
+}
+
+/* Reorder students[] to follow the n sorted keys with a single gather pass;
+   slots not named by a key (tombstones) are dropped */
+static void applyPermutation(const SortKey *keys, int n) {
+    StudentRecord *sorted = malloc(store->capacity * sizeof(StudentRecord));
+    if (!sorted) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        sorted[i] = store->students[keys[i].index];
+    }
+
+    int cap = store->capacity;
+    releaseStorage();
+    store->students     = sorted;
+    store->slotCount    = n;
+    store->studentCount = n;
+    store->capacity     = cap;
+    rebuildIndexes();
+}
+
+typedef struct {
+    const SortKey *keys;
+    int            n;
+} Permutation;
+
+static void changePermute(void *arg, int copy) {
+    (void)copy;
+    const Permutation *p = arg;
+    applyPermutation(p->keys, p->n);
+}
+
+/* Stable O(n log n) sort; equal keys keep their current relative order.
+   Both copies share one slot layout, so the keys are sorted only once. */
+void storeSort(SortField field) {
+    writeBegin();
+    if (store->studentCount < 2) {
+        writeEnd();
+        return;
+    }
+
+    SortKey *keys = malloc(store->studentCount * sizeof(SortKey));
+    if (!keys) {
+        printf("Error: memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    int n = 0;
+    for (int i = 0; i < store->slotCount; i++) {
+        if (!slotIsLive(i))
+            continue;
+        keys[n].index = i;
+        switch (field) {
+            case SORT_BY_GPA_DESC:
+                keys[n].key = 0xFFFFFFFFU - sortKeyFromFloat(store->students[i].gpa);
+                break;
+            case SORT_BY_NAME_ASC:
+                keys[n].key = sortKeyFromString(recordName(&store->students[i]));
+                break;
+            case SORT_BY_ID_ASC:
+                keys[n].key = sortKeyFromInt(store->students[i].id);
+                break;
         }
+        n++;
     }
+
+    keySort(keys, n);
+    if (field == SORT_BY_NAME_ASC)
+        keySortTies(keys, n, compareNames, store->students);
+
+    /* The gather also squeezes out any tombstones */
+    Permutation p = { keys, n };
+    applyChange(changePermute, &p);
+    writeEnd();
+    free(keys);
+}
+
+static void sortByGPA(void) {
+    storeSort(SORT_BY_GPA_DESC);
     printf("Sorted by GPA (descending).\n");
 }
 
 static void sortByName(void) {
-    for (int i = 0; i < studentCount - 1; i++) {
-        for (int j = 0; j < studentCount - i - 1; j++) {
-            if (strcmp(students[j].name, students[j + 1].name) > 0) {
-                Student temp = students[j];
-                students[j] = students[j + 1];
-                students[j + 1] = temp;
-            }
-        }
-    }
+    storeSort(SORT_BY_NAME_ASC);
     printf("Sorted by Name (A-Z).\n");
 }
 
 static void sortById(void) {
-    for (int i = 0; i < studentCount - 1; i++) {
-        for (int j = 0; j < studentCount - i - 1; j++) {
-            if (students[j].id > students[j + 1].id) {
-                Student temp = students[j];
-                students[j] = students[j + 1];
-                students[j + 1] = temp;
-            }
-        }
-    }
+    storeSort(SORT_BY_ID_ASC);
     printf("Sorted by ID (ascending).\n");
 }
 
@@ -376,6 +1599,10 @@ void searchSortMenu(void) {
     printf("3. Sort by GPA (desc)\n");
     printf("4. Sort by Name (A-Z)\n");
     printf("5. Sort by ID (asc)\n");
+    printf("6. Search by Name prefix\n");
+    printf("7. Search by Name (allow typos)\n");
+    printf("8. Students in a GPA range\n");
+    printf("9. Students in an age range\n");
     printf("0. Back\n");
     printf("Choice: ");
     scanf("%d", &choice);
@@ -386,6 +1613,10 @@ void searchSortMenu(void) {
         case 3: sortByGPA(); break;
         case 4: sortByName(); break;
         case 5: sortById(); break;
+        case 6: searchByNamePrefix(); break;
+        case 7: searchByNameFuzzy(); break;
+        case 8: searchByGpaRange(); break;
+        case 9: searchByAgeRange(); break;
         case 0:
         default: break;
     }
@@ -394,74 +1625,92 @@ void searchSortMenu(void) {
 /* ===================== Statistics & Reports ===================== */
 
 static void classStatistics(void) {
-    if (studentCount == 0) {
+    /* Mean/min/max come from one vectorized pass over the GPA column */
+    StoreStats st;
+    if (storeStats(NULL, &st) == 0) {
         printf("No students to analyze.\n");
         return;
     }
 
-    float sum = 0.0f;
-    float *gpas = malloc(studentCount * sizeof(float));
-    if (!gpas) {
-        printf("Memory error.\n");
+    /* Median and percentiles by selection on a scratch copy (linear time) */
+    const double percents[] = { 10.0, 50.0, 90.0, 99.0 };
+    float pct[4] = { 0 };
+    storeGpaPercentiles(NULL, percents, 4, pct);
+
+    printf("Class Average GPA: %.2f\n", st.avgGpa);
+    printf("Median GPA:        %.2f\n", pct[1]);
+    printf("Lowest GPA:        %.2f\n", st.minGpa);
+    printf("Highest GPA:       %.2f\n", st.maxGpa);
+    printf("10th percentile:   %.2f\n", pct[0]);
+    printf("90th percentile:   %.2f\n", pct[2]);
+    printf("99th percentile:   %.2f\n", pct[3]);
+    printf("Average Age:       %.1f\n", st.avgAge);
+}
+
+static void gpaHistogram(void) {
+    int counts[HISTOGRAM_BINS];
+    if (storeGpaHistogram(counts) == 0) {
+        printf("No students to analyze.\n");
         return;
     }
 
-    for (int i = 0; i < studentCount; i++) {
-        gpas[i] = students[i].gpa;
-        sum += students[i].gpa;
+    int peak = 1;
+    for (int b = 0; b < HISTOGRAM_BINS; b++)
+        if (counts[b] > peak) peak = counts[b];
+
+    const int width = 100 / HISTOGRAM_BINS;
+    for (int b = 0; b < HISTOGRAM_BINS; b++) {
+        int lo = b * width;
+        int bar = (int)((long long)counts[b] * 40 / peak);
+        printf("[%3d, %3d%c %-40.*s %d\n", lo, lo + width,
+               (b == HISTOGRAM_BINS - 1) ? ']' : ')', bar,
+               "########################################", counts[b]);
     }
+}
 
-    float average = sum / studentCount;
-
-    /* sort gpas for median (Bubble sort) */
-    for (int i = 0; i < studentCount - 1; i++) {
-        for (int j = 0; j < studentCount - i - 1; j++) {
-            if (gpas[j] > gpas[j + 1]) {
-                float tmp = gpas[j];
-                gpas[j] = gpas[j + 1];
-                gpas[j + 1] = tmp;
-            }
-        }
+/* Print the best N students (optionally of one course) without reordering the roster */
+static void printTopN(const char *course, int N) {
+    Student *top = malloc(N * sizeof(Student));
+    if (!top) {
+        printf("Memory error.\n");
+        return;
     }
 
-    float median;
-    if (studentCount % 2 == 1) {
-        median = gpas[studentCount / 2];
+    int found = storeTopStudents(course, N, top);
+    if (found == 0) {
+        printf("No students found.\n");
     } else {
-        median = (gpas[studentCount / 2 - 1] + gpas[studentCount / 2]) / 2.0f;
+        printf("Top %d student(s):\n", found);
+        for (int i = 0; i < found; i++) {
+            printStudent(&top[i]);
+        }
     }
-
-    float minGPA = gpas[0];
-    float maxGPA = gpas[studentCount - 1];
-
-    printf("Class Average GPA: %.2f\n", average);
-    printf("Median GPA:        %.2f\n", median);
-    printf("Lowest GPA:        %.2f\n", minGPA);
-    printf("Highest GPA:       %.2f\n", maxGPA);
-
-    free(gpas);
+    free(top);
 }
 
 static void topNStudents(void) {
-    if (studentCount == 0) {
-        printf("No students.\n");
+    int N;
+    printf("Enter N (top N students): ");
+    scanf("%d", &N);
+    if (N <= 0) {
+        printf("Invalid N.\n");
         return;
     }
+    printTopN(NULL, N);
+}
 
+static void topNInCourse(void) {
+    char course[MAX_COURSE];
     int N;
+    printf("Enter course name (exact): ");
+    scanf("%s", course);
     printf("Enter N (top N students): ");
     scanf("%d", &N);
     if (N <= 0) {
         printf("Invalid N.\n");
         return;
     }
-    if (N > studentCount) N = studentCount;
-
-    sortByGPA(); /* sorts in place, descending */
-    printf("Top %d student(s):\n", N);
-    for (int i = 0; i < N; i++) {
-        displayStudent(&students[i]);
-    }
+    printTopN(course, N);
 }
 
 static void topStudentPerCourse(void) {
@@ -469,22 +1718,12 @@ static void topStudentPerCourse(void) {
     printf("Enter course name to find top student (exact): ");
     scanf("%s", course);
 
-    int found = 0;
-    Student *top = NULL;
-    for (int i = 0; i < studentCount; i++) {
-        if (strcmp(students[i].course, course) == 0) {
-            if (!found || students[i].gpa > top->gpa) {
-                top = &students[i];
-                found = 1;
-            }
-        }
-    }
-
-    if (!found) {
+    CourseSummary cs;
+    if (storeCourseSummary(course, &cs) == 0) {
         printf("No students found for that course.\n");
     } else {
         printf("Top student in %s:\n", course);
-        displayStudent(top);
+        printStudent(&cs.top);
     }
 }
 
@@ -493,30 +1732,46 @@ static void courseAverageGPA(void) {
     printf("Enter course name for average GPA: ");
     scanf("%s", course);
 
-    float sum = 0.0f;
-    int count = 0;
-    for (int i = 0; i < studentCount; i++) {
-        if (strcmp(students[i].course, course) == 0) {
-            sum += students[i].gpa;
-            count++;
-        }
-    }
-
-    if (count == 0) {
+    CourseSummary cs;
+    if (storeCourseSummary(course, &cs) == 0) {
         printf("No students found for that course.\n");
     } else {
-        printf("Average GPA for course %s: %.2f\n",
-               course, sum / count);
+        printf("Average GPA for course %s: %.2f\n", course, cs.avgGpa);
+    }
+}
+
+/* Every course at once, straight from the maintained aggregates */
+static void allCoursesReport(void) {
+    int n = storeAllCourses(NULL, 0);
+    CourseSummary *rows = malloc((n > 0 ? n : 1) * sizeof(CourseSummary));
+    if (!rows) {
+        printf("Memory error.\n");
+        return;
+    }
+    /* A writer may add or empty a course in between; print what the second pass saw */
+    int total = storeAllCourses(rows, n);
+    int shown = (total < n) ? total : n;
+    for (int i = 0; i < shown; i++) {
+        printf("%-25s students: %-5d avg GPA: %6.2f  top: %s (%.2f)\n",
+               rows[i].course, rows[i].count, rows[i].avgGpa,
+               rows[i].top.name, rows[i].top.gpa);
+    }
+    free(rows);
+    if (shown == 0) {
+        printf("No students.\n");
     }
 }
 
 void reportsMenu(void) {
     int choice;
     printf("\n--- Reports & Analytics ---\n");
-    printf("1. Class statistics (avg, median, min, max GPA)\n");
+    printf("1. Class statistics (avg, median, min, max, percentiles)\n");
     printf("2. Top N students overall\n");
     printf("3. Top student per course\n");
     printf("4. Course-wise average GPA\n");
+    printf("5. All courses summary\n");
+    printf("6. GPA histogram\n");
+    printf("7. Top N students in a course\n");
     printf("0. Back\n");
     printf("Choice: ");
     scanf("%d", &choice);
@@ -526,6 +1781,9 @@ void reportsMenu(void) {
         case 2: topNStudents(); break;
         case 3: topStudentPerCourse(); break;
         case 4: courseAverageGPA(); break;
+        case 5: allCoursesReport(); break;
+        case 6: gpaHistogram(); break;
+        case 7: topNInCourse(); break;
         case 0:
         default: break;
     }
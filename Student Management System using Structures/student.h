@@ -1,12 +1,14 @@
 #ifndef STUDENT_H
 #define STUDENT_H
 
+#include <stdint.h>
 #include <stdio.h>
 
 #define MAX_NAME     50
 #define MAX_COURSE   50
 #define MAX_SUBJECTS 10
 #define DATA_FILE    "students.txt"
+#define SNAPSHOT_FILE "students.db"
 
 /*
  * Student structure:
@@ -28,15 +30,32 @@ typedef struct {
     float gpa;
 } Student;
 
+/*
+ * Compact form the store keeps in memory and in the snapshot (64 bytes):
+ *  - name is an offset into the store's name arena
+ *  - course is an id in the store's course dictionary (see strpool.h)
+ * Student stays the exchange format for input, the journal and students.txt.
+ */
+typedef struct {
+    int      id;
+    int      age;
+    uint32_t nameRef;
+    int      courseId;
+    int      numGrades;
+    float    grades[MAX_SUBJECTS];
+    float    gpa;
+} StudentRecord;
+
 /* Initialization and cleanup */
 void initSystem(void);     /* load data from file, initialize memory */
-void cleanupSystem(void);  /* free allocated memory */
+void cleanupSystem(void);  /* free allocated memory; no other thread may still use the store */
 
 /* CRUD operations */
 void addStudent(void);
 void displayAllStudents(void);
 void updateStudent(void);
-void deleteStudent(void);
+void deleteStudent(void);   /* O(1): leaves a tombstone, see compactStorage */
+void compactStorage(void);  /* reclaim tombstoned slots now */
 
 /* Search / Sort menu and logic */
 void searchSortMenu(void);
@@ -44,8 +63,110 @@ void searchSortMenu(void);
 /* Reports and analytics menu and logic */
 void reportsMenu(void);
 
-/* File operations (exposed so main can force save/load) */
+/* Text import/export (exposed so main can force save/load) */
 void saveToFile(const char *filename);
 void loadFromFile(const char *filename);
 
+/* Binary snapshot store (see snapshot.h); loadSnapshot returns 0 on success */
+void saveSnapshot(const char *filename);
+int  loadSnapshot(const char *filename);
+
+/*
+ * Store library API. Every store* function is thread-safe: readers never
+ * wait for writers (they keep using the previous version of the store
+ * while a change is applied), and writers are serialized.
+ */
+typedef enum {
+    STORE_OK        =  0,
+    STORE_NOT_FOUND = -1,
+    STORE_DUPLICATE = -2,
+    STORE_IO_ERROR  = -3   /* the journal write failed; nothing was changed */
+} StoreStatus;
+
+/* Durable single-record changes: journaled and fsync'd before readers see them.
+   Insert and update compute s->gpa from the grades. */
+StoreStatus storeInsertStudent(Student *s);
+StoreStatus storeUpdateStudent(Student *s);  /* replaces the record with s->id */
+StoreStatus storeRemoveStudent(int id);
+
+int  storeGetStudent(int id, Student *out);  /* 0 if found, -1 if not */
+
+/*
+ * Bulk changes (batch mode) apply in memory only;
+ * call saveSnapshot(SNAPSHOT_FILE) once afterwards to persist them.
+ */
+int  storeAddStudents(Student *records, int count);  /* returns number added; duplicate IDs are skipped */
+int  storeDeleteStudent(int id);                     /* 0 if deleted, -1 if not found */
+int  storeCompact(void);                             /* returns number of slots reclaimed */
+
+/* Range queries over the ordered GPA/age indexes; bounds are inclusive */
+typedef enum {
+    RANGE_BY_GPA,
+    RANGE_BY_AGE
+} RangeField;
+
+int  storeCountRange(RangeField field, float lo, float hi);
+/* Copies up to max matches to out, ascending by field; returns the total in range */
+int  storeRangeQuery(RangeField field, float lo, float hi, Student *out, int max);
+
+/* Name search through the trie; names compare case-insensitively */
+typedef enum {
+    NAME_EXACT,
+    NAME_PREFIX,
+    NAME_FUZZY   /* within maxDist edits, closest first */
+} NameSearchMode;
+
+/* Copies up to max matches to out (and each match's edit distance to dist,
+   if not NULL); returns the total number of matches */
+int  storeFindByName(NameSearchMode mode, const char *name, int maxDist,
+                     Student *out, int *dist, int max);
+
+/* GPA and age summary of one course, or of everyone if course is NULL */
+typedef struct {
+    int   count;
+    float avgGpa;
+    float minGpa;
+    float maxGpa;
+    float avgAge;
+} StoreStats;
+
+int  storeStats(const char *course, StoreStats *out);  /* returns the student count */
+/* Best n students by GPA (of one course, or everyone if NULL), best first; returns how many */
+int  storeTopStudents(const char *course, int n, Student *out);
+
+/* GPA percentiles (each in [0, 100], ascending) of one course or of everyone;
+   returns the student count (out is left untouched if it is 0) */
+int  storeGpaPercentiles(const char *course, const double *percents, int count, float *out);
+/* Students per GPA bucket, HISTOGRAM_BINS entries (see gpastats.h); returns the student count */
+int  storeGpaHistogram(int *counts);
+
+/* One course's line in the course reports, read from the maintained aggregates */
+typedef struct {
+    char    course[MAX_COURSE];
+    int     count;
+    float   avgGpa;
+    Student top;   /* highest GPA; ties go to the lower ID */
+} CourseSummary;
+
+int  storeCourseSummary(const char *course, CourseSummary *out);  /* returns the student count */
+/* Copies up to max summaries (one per course with students) to out;
+   returns how many such courses there are */
+int  storeAllCourses(CourseSummary *out, int max);
+
+/* Roster order; sorting is stable and also squeezes out deleted slots */
+typedef enum {
+    SORT_BY_GPA_DESC,
+    SORT_BY_NAME_ASC,
+    SORT_BY_ID_ASC
+} SortField;
+
+void storeSort(SortField field);
+
+/* Batch mode (batch.c); return 0 on success */
+int  runImport(const char *csvFile);
+int  runBatch(const char *commandFile);
+
+/* Unix-socket query server (server.c); returns 0 after a clean shutdown */
+int  runServer(const char *socketPath);
+
 #endif /* STUDENT_H */
\ No newline at end of file
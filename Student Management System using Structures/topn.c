@@ -0,0 +1,69 @@
+#include "topn.h"
+#include "columns.h"
+
+/* ===================== Internal Helpers ===================== */
+
+/* Does row a rank below row b? (lower GPA, or same GPA and later row) */
+static int ranksBelow(const float *gpa, int a, int b) {
+    return gpa[a] < gpa[b] || (gpa[a] == gpa[b] && a > b);
+}
+
+/* Min-heap on rank: heap[0] is the weakest row currently kept */
+static void siftDown(const float *gpa, int *heap, int size, int pos) {
+    int row = heap[pos];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && ranksBelow(gpa, heap[child + 1], heap[child]))
+            child++;
+        if (!ranksBelow(gpa, heap[child], row))
+            break;
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    heap[pos] = row;
+}
+
+static void siftUp(const float *gpa, int *heap, int pos) {
+    int row = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!ranksBelow(gpa, row, heap[parent]))
+            break;
+        heap[pos] = heap[parent];
+        pos = parent;
+    }
+    heap[pos] = row;
+}
+
+/* ===================== Public API ===================== */
+
+int topNSelect(const float *gpa, const int *courseId, int rows,
+               int course, int n, int *outRows) {
+    if (n <= 0)
+        return 0;
+
+    int *heap = outRows;  /* the output buffer doubles as the heap */
+    int size = 0;
+    for (int r = 0; r < rows; r++) {
+        if (course == ALL_COURSES ? courseId[r] < 0 : courseId[r] != course)
+            continue;
+        if (size < n) {
+            heap[size++] = r;
+            siftUp(gpa, heap, size - 1);
+        } else if (ranksBelow(gpa, heap[0], r)) {
+            heap[0] = r;
+            siftDown(gpa, heap, size, 0);
+        }
+    }
+
+    /* Heap-sort in place: repeatedly move the weakest row to the end */
+    for (int end = size - 1; end > 0; end--) {
+        int t = heap[0];
+        heap[0] = heap[end];
+        heap[end] = t;
+        siftDown(gpa, heap, end, 0);
+    }
+    return size;
+}
@@ -0,0 +1,20 @@
+#ifndef TOPN_H
+#define TOPN_H
+
+/*
+ * Top-N selection over the GPA/course columns without reordering them:
+ *  - a bounded min-heap keeps the best N rows seen so far: O(rows log N)
+ *  - ranking is GPA descending, then row ascending, so ties come out in
+ *    roster order (as the old stable sort did)
+ *  - reads the columns only, so any number of readers may run it at once
+ */
+
+/*
+ * Fill outRows with up to n row numbers, best first, considering rows whose
+ * course id equals courseId (or every row with ALL_COURSES from columns.h).
+ * Returns the number of rows written.
+ */
+int topNSelect(const float *gpa, const int *courseId, int rows,
+               int course, int n, int *outRows);
+
+#endif /* TOPN_H */